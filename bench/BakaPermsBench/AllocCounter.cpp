@@ -0,0 +1,83 @@
+// Counting replacements for the global allocation functions. This file takes the place of
+// Utils/Memory/MemoryOperators.cpp in the bench module, which is why the bench target excludes it.
+
+#include "BakaPermsBench/AllocCounter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace BakaPerms::bench {
+
+namespace {
+
+thread_local AllocCount tlAllocations;
+
+auto allocate(const std::size_t size) -> void* {
+    ++tlAllocations.count;
+    tlAllocations.bytes += size;
+    return std::malloc(size ? size : 1);
+}
+
+auto allocateAligned(const std::size_t size, const std::align_val_t align) -> void* {
+    ++tlAllocations.count;
+    tlAllocations.bytes += size;
+    const auto alignment = static_cast<std::size_t>(align);
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, alignment);
+#else
+    // aligned_alloc wants the size rounded up to a multiple of the alignment.
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+void freeAligned(void* ptr) noexcept {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+} // namespace
+
+auto currentAllocations() noexcept -> AllocCount { return tlAllocations; }
+
+} // namespace BakaPerms::bench
+
+using BakaPerms::bench::allocate;
+using BakaPerms::bench::allocateAligned;
+using BakaPerms::bench::freeAligned;
+
+void* operator new(const std::size_t size) {
+    if (auto* ptr = allocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size) {
+    if (auto* ptr = allocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new(const std::size_t size, const std::align_val_t align) {
+    if (auto* ptr = allocateAligned(size, align)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t align) {
+    if (auto* ptr = allocateAligned(size, align)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { freeAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { freeAligned(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { freeAligned(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { freeAligned(ptr); }
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BakaPerms::bench {
+
+struct AllocCount {
+    std::uint64_t count{0};
+    std::uint64_t bytes{0};
+
+    auto operator-(const AllocCount& other) const -> AllocCount {
+        return {count - other.count, bytes - other.bytes};
+    }
+};
+
+/// Allocations made through operator new by the calling thread so far. AllocCounter.cpp replaces the
+/// global operator new of this module, so work done on other threads or inside other modules
+/// (LeviLamina, the SQLite runtime) is not counted.
+auto currentAllocations() noexcept -> AllocCount;
+
+} // namespace BakaPerms::bench
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace BakaPerms::bench {
+
+struct BenchConfigV1 {
+    int         version         = 1;
+    int         Samples         = 200;            // timed samples per benchmark
+    int         MinSampleMicros = 100;            // ops are batched until a sample takes at least this long
+    std::string Output          = "results.json"; // relative path from dataDir, or absolute
+    struct Dataset {
+        std::string Name;
+        int         GroupDepth  = 4;
+        int         GroupFanOut = 3;
+        int         NodeDepth   = 5;
+        int         AclLength   = 8;
+        int         Players     = 1000;
+        int         AclNodes    = 500;
+        int         Seed        = 1;
+    };
+    std::vector<Dataset> Datasets = {
+        {.Name = "default"},
+        {.Name = "deep", .GroupDepth = 8, .GroupFanOut = 2, .NodeDepth = 10, .AclLength = 32},
+        {.Name = "wide", .GroupDepth = 2, .GroupFanOut = 64, .Players = 20000, .AclNodes = 5000},
+    };
+};
+
+using BenchConfig = BenchConfigV1;
+
+} // namespace BakaPerms::bench
@@ -0,0 +1,160 @@
+#include "BakaPermsBench/BenchMod.hpp"
+
+#include "BakaPerms/Core/PermissionManager.hpp"
+#include "BakaPerms/Core/PermissionSnapshot.hpp"
+#include "BakaPerms/Data/PermissionRepository.hpp"
+#include "BakaPerms/Database/SQLite/SQLiteDatabase.h"
+#include "BakaPerms/StdAfx.hpp"
+#include "BakaPermsBench/BenchConfig.hpp"
+#include "BakaPermsBench/Dataset.hpp"
+#include "BakaPermsBench/Runner.hpp"
+#include "BakaPermsBench/Suites.hpp"
+
+#include <ll/api/Config.h>
+#include <ll/api/mod/RegisterHelper.h>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+namespace BakaPerms {
+
+// The code under test logs through BakaPerms::getInstance(); in this module that is the bench mod.
+BakaPerms& BakaPerms::getInstance() {
+    static BakaPerms instance;
+    return instance;
+}
+
+} // namespace BakaPerms
+
+namespace BakaPerms::bench {
+
+namespace {
+
+BenchConfig config;
+
+auto toShape(const BenchConfig::Dataset& dataset) -> DatasetShape {
+    return {
+        .name        = dataset.Name,
+        .groupDepth  = dataset.GroupDepth,
+        .groupFanOut = dataset.GroupFanOut,
+        .nodeDepth   = dataset.NodeDepth,
+        .aclLength   = dataset.AclLength,
+        .players     = dataset.Players,
+        .aclNodes    = dataset.AclNodes,
+        .seed        = static_cast<std::uint32_t>(dataset.Seed),
+    };
+}
+
+auto toJson(const DatasetShape& shape) -> nlohmann::ordered_json {
+    return {
+        {"name",          shape.name       },
+        {"group_depth",   shape.groupDepth },
+        {"group_fan_out", shape.groupFanOut},
+        {"node_depth",    shape.nodeDepth  },
+        {"acl_length",    shape.aclLength  },
+        {"players",       shape.players    },
+        {"acl_nodes",     shape.aclNodes   },
+        {"seed",          shape.seed       },
+    };
+}
+
+auto runDataset(const DatasetShape& shape, const std::filesystem::path& dir, const RunnerOptions& options)
+    -> nlohmann::ordered_json {
+    const auto dbPath = dir / (shape.name + ".db");
+    for (const auto* suffix : {"", "-wal", "-shm"}) {
+        std::filesystem::remove(std::filesystem::path(dbPath) += suffix);
+    }
+
+    Runner  runner(options);
+    Dataset dataset;
+    {
+        database::SQLiteDatabase   db(dbPath);
+        data::PermissionRepository repo(db);
+        repo.initializeSchema();
+        dataset = generateDataset(db, repo, shape);
+        runResolverSuite(runner, *core::PermissionSnapshot::load(repo), dataset);
+        runRepositorySuite(runner, repo, dataset);
+    }
+    {
+        core::PermissionManagerOptions managerOptions;
+        managerOptions.asyncThreads       = 1;
+        managerOptions.learnedWarmUpNodes = 0;
+        core::PermissionManager manager(std::make_unique<database::SQLiteDatabase>(dbPath), std::move(managerOptions));
+        runManagerSuite(runner, manager, dataset);
+    }
+
+    auto results = nlohmann::ordered_json::array();
+    for (const auto& result : runner.results()) {
+        logger.info(
+            "{:<52} {:>12.1f} ns/op {:>8.2f} allocs/op  p50 {:>12.1f}  p99 {:>12.1f}",
+            result.name,
+            result.nsPerOp,
+            result.allocsPerOp,
+            result.p50Ns,
+            result.p99Ns
+        );
+        results.push_back(toJson(result));
+    }
+    return {
+        {"dataset", toJson(shape)     },
+        {"results", std::move(results)},
+    };
+}
+
+} // namespace
+
+BenchMod& BenchMod::getInstance() {
+    static BenchMod instance;
+    return instance;
+}
+
+bool BenchMod::load() {
+    const auto configPath = getSelf().getConfigDir() / "config.json";
+    if (ll::config::loadConfig(config, configPath)) {
+        ll::config::saveConfig(config, configPath);
+    }
+    return true;
+}
+
+bool BenchMod::enable() {
+    RunnerOptions options;
+    options.samples       = static_cast<std::size_t>(std::max(config.Samples, 1));
+    options.minSampleTime = std::chrono::microseconds(std::max(config.MinSampleMicros, 0));
+
+    // Runs to completion before the server finishes starting; this mod is only loaded to benchmark.
+    try {
+        const auto dataDir = getSelf().getDataDir();
+        std::filesystem::create_directories(dataDir);
+
+        nlohmann::ordered_json report{
+            {"format",   "bakaperms-bench"             },
+            {"version",  1                             },
+            {"datasets", nlohmann::ordered_json::array()},
+        };
+        for (const auto& dataset : config.Datasets) {
+            logger.info("Benchmarking dataset '{}'", dataset.Name);
+            report["datasets"].push_back(runDataset(toShape(dataset), dataDir, options));
+        }
+
+        const auto    output = dataDir / config.Output;
+        std::ofstream file(output);
+        file << report.dump(2) << '\n';
+        if (!file.flush()) throw std::runtime_error("Failed to write " + output.string());
+        logger.info("Benchmark results written to {}", output.string());
+    } catch (const std::exception& e) {
+        logger.error("Benchmark failed: {}", e.what());
+    }
+    return true;
+}
+
+bool BenchMod::disable() { return true; }
+
+} // namespace BakaPerms::bench
+
+LL_REGISTER_MOD(BakaPerms::bench::BenchMod, BakaPerms::bench::BenchMod::getInstance());
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ll/api/mod/NativeMod.h>
+
+namespace BakaPerms::bench {
+
+/// Development mod that runs the benchmark suites when the server enables it and writes the results
+/// as JSON to its data directory. It links its own copy of the code under test and generates its own
+/// databases, so it never touches an installed BakaPerms.
+class BenchMod {
+public:
+    static BenchMod& getInstance();
+
+    BenchMod() : mSelf(*ll::mod::NativeMod::current()) {}
+
+    [[nodiscard]] ll::mod::NativeMod& getSelf() const { return mSelf; }
+
+    bool load();
+    bool enable();
+    bool disable();
+
+private:
+    ll::mod::NativeMod& mSelf;
+};
+
+} // namespace BakaPerms::bench
@@ -0,0 +1,95 @@
+#include "BakaPermsBench/Dataset.hpp"
+
+#include <algorithm>
+#include <format>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+namespace BakaPerms::bench {
+
+namespace {
+
+constexpr std::size_t kSegmentsPerLevel = 8;
+constexpr std::size_t kProbeNodes       = 256;
+constexpr int         kGroupTag         = 1;
+constexpr int         kPlayerTag        = 2;
+
+auto makeUuid(const int tag, const std::size_t index) -> std::string {
+    return std::format("{:08x}-0000-4000-8000-{:012x}", tag, index);
+}
+
+} // namespace
+
+auto generateDataset(database::IDatabase& db, const data::PermissionRepository& repo, const DatasetShape& shape)
+    -> Dataset {
+    // mt19937's output is fixed by the standard, unlike the distributions, so indices are taken modulo.
+    std::mt19937 rng(shape.seed);
+    const auto   pick = [&rng](const std::size_t bound) { return static_cast<std::size_t>(rng()) % bound; };
+
+    const auto groupDepth  = std::max(shape.groupDepth, 1);
+    const auto groupFanOut = static_cast<std::size_t>(std::max(shape.groupFanOut, 1));
+    const auto nodeDepth   = static_cast<std::size_t>(std::max(shape.nodeDepth, 1));
+
+    Dataset dataset;
+    db.withTransaction([&] {
+        // Group tree: group j of a level is the child of group j / groupFanOut of the level above.
+        std::size_t parentStart = 0;
+        std::size_t levelSize   = 1;
+        for (int level = 0; level < groupDepth; ++level) {
+            const auto levelStart = dataset.groups.size();
+            for (std::size_t j = 0; j < levelSize; ++j) {
+                auto                            uuid = makeUuid(kGroupTag, dataset.groups.size());
+                std::optional<std::string_view> parent;
+                if (level > 0) parent = dataset.groups[parentStart + j / groupFanOut];
+                repo.createGroup(uuid, std::format("bench_{}", dataset.groups.size()), parent);
+                dataset.groups.push_back(std::move(uuid));
+            }
+            parentStart  = levelStart;
+            levelSize   *= groupFanOut;
+        }
+        const auto leafStart = parentStart;
+        const auto leafCount = dataset.groups.size() - leafStart;
+
+        for (int i = 0; i < shape.players; ++i) {
+            auto uuid = makeUuid(kPlayerTag, static_cast<std::size_t>(i));
+            (void)repo.addPlayerToGroup(uuid, dataset.groups[leafStart + pick(leafCount)]);
+            if (pick(2) == 0) (void)repo.addPlayerToGroup(uuid, dataset.groups[pick(dataset.groups.size())]);
+            dataset.players.push_back(std::move(uuid));
+        }
+
+        const auto makeNode = [&](const std::size_t segments) {
+            std::string node = "bench";
+            for (std::size_t i = 1; i < segments; ++i) node += std::format(".s{}", pick(kSegmentsPerLevel));
+            return node;
+        };
+
+        // A quarter of the ACEs name a player directly, the rest a group at any level.
+        std::unordered_set<std::string> seen;
+        for (int attempt = 0; std::cmp_less(dataset.aclNodes.size(), shape.aclNodes) && attempt < shape.aclNodes * 4;
+             ++attempt) {
+            auto node = makeNode(1 + pick(nodeDepth));
+            if (!seen.insert(node).second) continue;
+            for (int position = 0; position < shape.aclLength; ++position) {
+                const bool  player  = !dataset.players.empty() && pick(4) == 0;
+                const auto& subject = player ? dataset.players[pick(dataset.players.size())]
+                                             : dataset.groups[pick(dataset.groups.size())];
+                repo.putACE(
+                    node,
+                    position,
+                    subject,
+                    static_cast<int>(player ? core::SubjectKind::Player : core::SubjectKind::Group),
+                    pick(2) == 0 ? core::AccessMask::Allow : core::AccessMask::Deny
+                );
+            }
+            dataset.aclNodes.push_back(std::move(node));
+        }
+
+        for (std::size_t i = 0; i < kProbeNodes; ++i) dataset.probeNodes.push_back(makeNode(nodeDepth));
+    });
+    return dataset;
+}
+
+} // namespace BakaPerms::bench
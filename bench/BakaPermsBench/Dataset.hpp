@@ -0,0 +1,34 @@
+#pragma once
+#include "BakaPerms/Data/PermissionRepository.hpp"
+#include "BakaPerms/Database/IDatabase.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BakaPerms::bench {
+
+struct DatasetShape {
+    std::string   name{"default"};
+    int           groupDepth{4};  // levels in the group tree; leaf groups inherit from groupDepth - 1 ancestors
+    int           groupFanOut{3}; // child groups per non-leaf group
+    int           nodeDepth{5};   // segments in a probed node; ACLs sit at depth 1 to nodeDepth
+    int           aclLength{8};   // ACEs per ACL
+    int           players{1000};
+    int           aclNodes{500};
+    std::uint32_t seed{1};
+};
+
+struct Dataset {
+    std::vector<std::string> groups;  // root first, then level by level
+    std::vector<std::string> players; // each belongs to a leaf group, some to a second group
+    std::vector<std::string> aclNodes;
+    std::vector<std::string> probeNodes; // full-depth nodes, mostly resolved through a parent's ACL
+};
+
+/// Fill an empty schema with data of the given shape, in one transaction. The same shape always
+/// produces the same data.
+auto generateDataset(database::IDatabase& db, const data::PermissionRepository& repo, const DatasetShape& shape)
+    -> Dataset;
+
+} // namespace BakaPerms::bench
@@ -0,0 +1,56 @@
+#include "BakaPermsBench/Runner.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace BakaPerms::bench {
+
+namespace {
+
+// Nearest-rank percentile of sorted samples.
+auto percentile(const std::vector<double>& sorted, const double p) -> double {
+    if (sorted.empty()) return 0;
+    const auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+} // namespace
+
+auto Runner::summarize(
+    std::string                    name,
+    std::vector<double>            samplesNs,
+    const std::uint64_t            iterations,
+    const std::chrono::nanoseconds elapsed,
+    const AllocCount&              allocations
+) -> BenchResult {
+    std::ranges::sort(samplesNs);
+    const auto ops = static_cast<double>(std::max<std::uint64_t>(iterations, 1));
+
+    BenchResult result;
+    result.name        = std::move(name);
+    result.iterations  = iterations;
+    result.nsPerOp     = static_cast<double>(elapsed.count()) / ops;
+    result.allocsPerOp = static_cast<double>(allocations.count) / ops;
+    result.bytesPerOp  = static_cast<double>(allocations.bytes) / ops;
+    result.p50Ns       = percentile(samplesNs, 0.50);
+    result.p90Ns       = percentile(samplesNs, 0.90);
+    result.p99Ns       = percentile(samplesNs, 0.99);
+    result.maxNs       = samplesNs.empty() ? 0 : samplesNs.back();
+    return result;
+}
+
+auto toJson(const BenchResult& result) -> nlohmann::ordered_json {
+    return {
+        {"name",          result.name       },
+        {"iterations",    result.iterations },
+        {"ns_per_op",     result.nsPerOp    },
+        {"allocs_per_op", result.allocsPerOp},
+        {"bytes_per_op",  result.bytesPerOp },
+        {"p50_ns",        result.p50Ns      },
+        {"p90_ns",        result.p90Ns      },
+        {"p99_ns",        result.p99Ns      },
+        {"max_ns",        result.maxNs      },
+    };
+}
+
+} // namespace BakaPerms::bench
@@ -0,0 +1,135 @@
+#pragma once
+#include "BakaPermsBench/AllocCounter.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace BakaPerms::bench {
+
+struct RunnerOptions {
+    std::size_t              samples{200};                                  // timed samples per benchmark
+    std::chrono::nanoseconds minSampleTime{std::chrono::microseconds(100)}; // a sample batches ops until this long
+    std::size_t              maxBatch{1 << 20};
+};
+
+struct BenchResult {
+    std::string   name;
+    std::uint64_t iterations{0};
+    double        nsPerOp{0};
+    double        allocsPerOp{0};
+    double        bytesPerOp{0};
+    // Percentiles over samples of the per-op time; with batches of one op these are single-op latencies.
+    double p50Ns{0};
+    double p90Ns{0};
+    double p99Ns{0};
+    double maxNs{0};
+};
+
+/// Times one operation at a time: calibrates a batch size, then records `samples` batches and
+/// reports the mean, the per-sample percentiles and the operator new calls per op.
+class Runner {
+public:
+    explicit Runner(const RunnerOptions& options) : options_(options) {}
+
+    template <typename Fn>
+    void run(std::string name, Fn&& fn);
+
+    /// Like run(), but calls `setup` before every op, outside both the timed region and the allocation
+    /// count. Ops are timed one by one, so this suits ops well above the clock's resolution.
+    template <typename Setup, typename Fn>
+    void run(std::string name, Setup&& setup, Fn&& fn);
+
+    [[nodiscard]] auto results() const -> const std::vector<BenchResult>& { return results_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static auto summarize(
+        std::string              name,
+        std::vector<double>      samplesNs,
+        std::uint64_t            iterations,
+        std::chrono::nanoseconds elapsed,
+        const AllocCount&        allocations
+    ) -> BenchResult;
+
+    RunnerOptions            options_;
+    std::vector<BenchResult> results_;
+};
+
+template <typename Fn>
+void Runner::run(std::string name, Fn&& fn) {
+    // Calibration doubles as warm-up: grow the batch until one outlasts the clock's resolution.
+    std::size_t batch = 1;
+    for (;;) {
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < batch; ++i) fn();
+        if (Clock::now() - start >= options_.minSampleTime || batch >= options_.maxBatch) break;
+        batch *= 2;
+    }
+
+    std::vector<double> samplesNs;
+    samplesNs.reserve(options_.samples); // before counting, so the loop below allocates nothing itself
+    std::chrono::nanoseconds elapsed{0};
+    const auto               allocationsBefore = currentAllocations();
+    for (std::size_t sample = 0; sample < options_.samples; ++sample) {
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < batch; ++i) fn();
+        const auto sampleTime  = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+        elapsed               += sampleTime;
+        samplesNs.push_back(static_cast<double>(sampleTime.count()) / static_cast<double>(batch));
+    }
+    const auto allocations = currentAllocations() - allocationsBefore;
+
+    results_.push_back(
+        summarize(std::move(name), std::move(samplesNs), batch * options_.samples, elapsed, allocations)
+    );
+}
+
+template <typename Setup, typename Fn>
+void Runner::run(std::string name, Setup&& setup, Fn&& fn) {
+    AllocCount allocations;
+    const auto timeOp = [&] {
+        setup();
+        const auto allocationsBefore = currentAllocations();
+        const auto start             = Clock::now();
+        fn();
+        const auto opTime  = Clock::now() - start;
+        const auto made    = currentAllocations() - allocationsBefore;
+        allocations.count += made.count;
+        allocations.bytes += made.bytes;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(opTime);
+    };
+
+    std::size_t batch = 1;
+    for (;;) {
+        std::chrono::nanoseconds batchTime{0};
+        for (std::size_t i = 0; i < batch; ++i) batchTime += timeOp();
+        if (batchTime >= options_.minSampleTime || batch >= options_.maxBatch) break;
+        batch *= 2;
+    }
+
+    std::vector<double> samplesNs;
+    samplesNs.reserve(options_.samples);
+    std::chrono::nanoseconds elapsed{0};
+    allocations = {};
+    for (std::size_t sample = 0; sample < options_.samples; ++sample) {
+        std::chrono::nanoseconds sampleTime{0};
+        for (std::size_t i = 0; i < batch; ++i) sampleTime += timeOp();
+        elapsed += sampleTime;
+        samplesNs.push_back(static_cast<double>(sampleTime.count()) / static_cast<double>(batch));
+    }
+
+    results_.push_back(
+        summarize(std::move(name), std::move(samplesNs), batch * options_.samples, elapsed, allocations)
+    );
+}
+
+/// Machine-readable form of a run, as written to the results file.
+auto toJson(const BenchResult& result) -> nlohmann::ordered_json;
+
+} // namespace BakaPerms::bench
@@ -0,0 +1,147 @@
+#include "BakaPermsBench/Suites.hpp"
+
+#include "BakaPerms/Core/NodePattern.hpp"
+#include "BakaPerms/Core/PermissionResolver.hpp"
+
+#include <algorithm>
+#include <set>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace BakaPerms::bench {
+
+namespace {
+
+volatile std::size_t gSink;
+
+// Store a result so the work producing it cannot be optimised away.
+template <typename T>
+void keep(const T& value) {
+    gSink = static_cast<std::size_t>(value);
+}
+
+} // namespace
+
+void runResolverSuite(Runner& runner, const core::PermissionSnapshot& snapshot, const Dataset& dataset) {
+    const auto& players = dataset.players;
+    const auto& probes  = dataset.probeNodes;
+    if (players.empty() || probes.empty()) return;
+    std::size_t i = 0;
+
+    runner.run("resolver.buildNodePath", [&] {
+        keep(core::PermissionResolver::buildNodePath(probes[i++ % probes.size()]).size());
+    });
+
+    runner.run("snapshot.findNearestACL", [&] { keep(snapshot.findNearestACL(probes[i++ % probes.size()]).size()); });
+
+    runner.run("snapshot.buildToken", [&] {
+        keep(snapshot.buildToken(core::SubjectKind::Player, players[i++ % players.size()]).entries().size());
+    });
+
+    // Tokens and nearest ACLs are prepared up front so only the ACE scan is timed.
+    struct Case {
+        core::AccessToken          token;
+        std::span<const core::ACE> acl;
+    };
+    std::vector<Case> cases;
+    for (std::size_t k = 0; k < probes.size(); ++k) {
+        cases.push_back(
+            {snapshot.buildToken(core::SubjectKind::Player, players[k % players.size()]),
+             snapshot.findNearestACL(probes[k])}
+        );
+    }
+    runner.run("resolver.resolve", [&] {
+        const auto& c = cases[i++ % cases.size()];
+        keep(core::PermissionResolver::resolve(c.acl, c.token));
+    });
+
+    // Wildcard versions of the ACL nodes: the second segment becomes "*", every third pattern ends in
+    // "**". Matching should cost the same with 16 patterns as with 4096.
+    std::set<std::string> unique;
+    for (std::size_t k = 0; !dataset.aclNodes.empty() && unique.size() < 4096 && k < 4 * 4096; ++k) {
+        const auto& node  = dataset.aclNodes[k % dataset.aclNodes.size()];
+        const auto  first = node.find('.');
+        if (first == std::string::npos) continue;
+        const auto second  = node.find('.', first + 1);
+        auto       pattern = node.substr(0, first + 1) + "*";
+        if (second != std::string::npos) pattern += node.substr(second);
+        pattern += k % 3 == 0 ? ".**" : "." + std::to_string(k);
+        unique.insert(std::move(pattern));
+    }
+    const std::vector<std::string> patterns(unique.begin(), unique.end());
+    for (const std::size_t count : {std::size_t{16}, std::size_t{4096}}) {
+        if (patterns.size() < count) break;
+        const core::NodePatternMatcher matcher(std::vector(patterns.begin(), patterns.begin() + count));
+        runner.run("patterns.match/" + std::to_string(count), [&] {
+            keep(matcher.match(probes[i++ % probes.size()]).id);
+        });
+    }
+}
+
+void runRepositorySuite(Runner& runner, const data::PermissionRepository& repo, const Dataset& dataset) {
+    const auto& players = dataset.players;
+    const auto& groups  = dataset.groups;
+    const auto& nodes   = dataset.aclNodes;
+    if (players.empty() || nodes.empty()) return;
+    std::size_t i = 0;
+
+    runner.run("repository.getNodeACL", [&] { keep(repo.getNodeACL(nodes[i++ % nodes.size()]).size()); });
+
+    const auto                     batchSize = static_cast<std::ptrdiff_t>(std::min<std::size_t>(nodes.size(), 16));
+    const std::vector<std::string> batch(nodes.begin(), nodes.begin() + batchSize);
+    runner.run("repository.getNodeACLBatch", [&] { keep(repo.getNodeACLBatch(batch).size()); });
+
+    runner.run("repository.getPlayerGroups", [&] {
+        keep(repo.getPlayerGroups(players[i++ % players.size()]).size());
+    });
+
+    runner.run("repository.getGroupAncestry", [&] { keep(repo.getGroupAncestry(groups[i++ % groups.size()]).size()); });
+
+    // Writes come in pairs, or are moves, that leave the data as they found it.
+    const auto& node   = nodes.front();
+    const auto& player = players.front();
+    runner.run("repository.insertACE+removeACE", [&] {
+        repo.insertACE(node, 0, player, static_cast<int>(core::SubjectKind::Player), core::AccessMask::Allow);
+        repo.removeACE(node, 0);
+    });
+
+    if (const auto last = static_cast<int>(repo.getNodeACL(node).size()) - 1; last > 0) {
+        runner.run("repository.moveACE", [&] { repo.moveACE(node, 0, last); });
+    }
+
+    const std::string newcomer = "bench-newcomer";
+    runner.run("repository.addPlayerToGroup+removePlayerFromGroup", [&] {
+        const auto& group = groups[i++ % groups.size()];
+        keep(repo.addPlayerToGroup(newcomer, group));
+        keep(repo.removePlayerFromGroup(newcomer, group));
+    });
+}
+
+void runManagerSuite(Runner& runner, core::PermissionManager& manager, const Dataset& dataset) {
+    const auto& players = dataset.players;
+    const auto& probes  = dataset.probeNodes;
+    if (players.empty() || probes.empty()) return;
+    std::size_t i = 0;
+
+    // A working set small enough to stay cached: after the first pass every check is a hit.
+    const auto hotPlayers = std::min<std::size_t>(players.size(), 16);
+    const auto hotNodes   = std::min<std::size_t>(probes.size(), 16);
+    runner.run("manager.checkPermission.hit", [&] {
+        const auto k = i++;
+        keep(manager.checkPermission(players[k % hotPlayers], probes[k / hotPlayers % hotNodes]));
+    });
+
+    // Clearing every cache first makes each check rebuild the player's token and resolve the node. The
+    // clear itself is untimed setup.
+    runner.run(
+        "manager.checkPermission.miss",
+        [&] { manager.invalidateAll(); },
+        [&] {
+            const auto k = i++;
+            keep(manager.checkPermission(players[k % players.size()], probes[k % probes.size()]));
+        }
+    );
+}
+
+} // namespace BakaPerms::bench
@@ -0,0 +1,19 @@
+#pragma once
+#include "BakaPerms/Core/PermissionManager.hpp"
+#include "BakaPerms/Core/PermissionSnapshot.hpp"
+#include "BakaPerms/Data/PermissionRepository.hpp"
+#include "BakaPermsBench/Dataset.hpp"
+#include "BakaPermsBench/Runner.hpp"
+
+namespace BakaPerms::bench {
+
+/// PermissionResolver::buildNodePath / resolve, and the snapshot lookups feeding them.
+void runResolverSuite(Runner& runner, const core::PermissionSnapshot& snapshot, const Dataset& dataset);
+
+/// PermissionRepository reads, and writes paired so the data is unchanged after each op.
+void runRepositorySuite(Runner& runner, const data::PermissionRepository& repo, const Dataset& dataset);
+
+/// PermissionManager::checkPermission with the decision cached and with every cache cleared.
+void runManagerSuite(Runner& runner, core::PermissionManager& manager, const Dataset& dataset);
+
+} // namespace BakaPerms::bench
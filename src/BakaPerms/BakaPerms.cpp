@@ -2,20 +2,68 @@
 
 #include "BakaPerms/Commands/PermsCommand.hpp"
 #include "BakaPerms/Config.hpp"
+#include "BakaPerms/Database/PostgreSQL/PostgreSQLDatabase.h"
 #include "BakaPerms/Database/SQLite/SQLiteDatabase.h"
 #include "BakaPerms/Utils/I18n/I18n.hpp"
+#include "BakaPerms/Utils/Metrics/PrometheusText.hpp"
 
 #include <ll/api/event/EventBus.h>
 #include <ll/api/event/player/PlayerDisconnectEvent.h>
+#include <ll/api/event/player/PlayerJoinEvent.h>
 #include <ll/api/mod/RegisterHelper.h>
 #include <ll/api/service/PlayerInfo.h>
 #include <ll/api/service/ServiceManager.h>
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
+#include <format>
+#include <fstream>
 #include <memory>
+#include <utility>
 
 namespace BakaPerms {
 
+constexpr auto kHotDecisionsFile  = "hot_decisions.bin";
+constexpr auto kSnapshotImageFile = "snapshot.bin";
+
+static auto toMillis(const std::chrono::nanoseconds ns) -> std::string {
+    return std::format("{:.1f}", std::chrono::duration<double, std::milli>(ns).count());
+}
+
+static void logSlowQuery(const database::SlowQueryReport& report) {
+    const auto& phases = report.phases;
+    logger.warn(
+        "{}",
+        "bakaperms.sql.slow_query"_tr(
+            toMillis(phases.total()),
+            toMillis(phases.lockWait),
+            toMillis(phases.prepare),
+            toMillis(phases.step),
+            toMillis(phases.extract),
+            phases.rows,
+            report.sql
+        )
+    );
+    if (!report.plan.empty()) logger.warn("{}", "bakaperms.sql.query_plan"_tr(report.plan));
+    if (report.suppressed > 0) logger.warn("{}", "bakaperms.sql.slow_query_suppressed"_tr(report.suppressed));
+}
+
+// Written beside `path` and renamed over it, so a scraper never reads a partial file.
+static void writeMetrics(const core::IPermissionManager& manager, const std::filesystem::path& path) {
+    utils::metrics::PrometheusText text;
+    manager.collectMetrics(text);
+
+    auto tmp = path;
+    tmp     += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out << text.str();
+        if (!out.flush()) throw std::runtime_error("failed to write " + tmp.string());
+    }
+    std::filesystem::rename(tmp, path);
+}
+
 BakaPerms& BakaPerms::getInstance() {
     static BakaPerms instance;
     return instance;
@@ -32,16 +80,54 @@ bool BakaPerms::load() {
         const auto dataDir = getSelf().getDataDir();
         std::filesystem::create_directories(dataDir);
 
-        auto dbPath = dataDir / "permissions.db";
+        std::unique_ptr<database::IDatabase> db;
         if (config::config.Database.Type == "sqlite") {
-            dbPath       = dataDir / config::config.Database.SQLite.Path;
-            auto db      = std::make_unique<database::SQLiteDatabase>(dbPath);
-            mPermManager = std::make_shared<core::PermissionManager>(std::move(db));
-        } else if (/*config::config.Database.Type == "postgresql"*/ true) {
+            const auto&             sqlite = config::config.Database.SQLite;
+            database::SQLiteOptions options;
+            options.statementCacheSize = static_cast<std::size_t>(std::max(sqlite.StatementCacheSize, 0));
+            options.readConnections    = static_cast<std::size_t>(std::max(sqlite.ReadConnections, 0));
+            options.slowQueryThreshold = std::chrono::milliseconds(std::max(sqlite.SlowQueryMillis, 0));
+            options.slowQueryInterval  = std::chrono::seconds(std::max(sqlite.SlowQueryLogIntervalSeconds, 1));
+            options.onSlowQuery        = logSlowQuery;
+
+            db = std::make_unique<database::SQLiteDatabase>(dataDir / sqlite.Path, options);
+        } else if (config::config.Database.Type == "postgresql") {
+            const auto&                 postgres = config::config.Database.PostgreSQL;
+            database::PostgreSQLOptions options;
+            options.host                  = postgres.Host;
+            options.port                  = postgres.Port;
+            options.user                  = postgres.Username;
+            options.password              = postgres.Password;
+            options.database              = postgres.Database;
+            options.sslMode               = postgres.SSLMode;
+            options.connectTimeoutSeconds = std::max(postgres.ConnectTimeoutSeconds, 0);
+            options.statementCacheSize    = static_cast<std::size_t>(std::max(postgres.StatementCacheSize, 0));
+            options.readConnections       = static_cast<std::size_t>(std::max(postgres.ReadConnections, 0));
+            options.slowQueryThreshold    = std::chrono::milliseconds(std::max(postgres.SlowQueryMillis, 0));
+            options.slowQueryInterval     = std::chrono::seconds(std::max(postgres.SlowQueryLogIntervalSeconds, 1));
+            options.onSlowQuery           = logSlowQuery;
+
+            db = std::make_unique<database::PostgreSQLDatabase>(options);
+        } else {
             throw utils::exception::InvalidArgumentException(
                 "bakaperms.error.unsupported_db"_tr(config::config.Database.Type)
             );
         }
+
+        const auto&                    performance = config::config.Performance;
+        core::PermissionManagerOptions managerOptions;
+        managerOptions.asyncThreads       = static_cast<std::size_t>(std::max(performance.AsyncWorkerThreads, 1));
+        managerOptions.warmUpNodes        = performance.WarmUpNodes;
+        managerOptions.learnedWarmUpNodes = static_cast<std::size_t>(std::max(performance.LearnedWarmUpNodes, 0));
+        managerOptions.auditThreads       = static_cast<std::size_t>(std::max(performance.AuditThreads, 0));
+        if (performance.SnapshotImage) managerOptions.snapshotImagePath = dataDir / kSnapshotImageFile;
+        mPermManager = std::make_shared<core::PermissionManager>(std::move(db), std::move(managerOptions));
+
+        if (performance.PersistedDecisions > 0) {
+            if (const auto hot = core::hot_decision_file::load(dataDir / kHotDecisionsFile)) {
+                logger.info("{}", "bakaperms.cache.restored"_tr(mPermManager->importHotDecisions(*hot)));
+            }
+        }
         return true;
     } catch (utils::exception::BakaException& e) {
         e.printException();
@@ -57,31 +143,100 @@ bool BakaPerms::enable() {
 
     auto& eventBus = ll::event::EventBus::getInstance();
 
+    // Join fires before the player is spawned in; resolving the token and hot nodes now means
+    // their first checks are cache hits.
+    mPlayerJoinListener = eventBus.emplaceListener<ll::event::PlayerJoinEvent>(
+        [this](const ll::event::PlayerJoinEvent& event) {
+            mPermManager->warmUpPlayer(event.self().getUuid().asString());
+        }
+    );
+
     mPlayerDisconnectListener = eventBus.emplaceListener<ll::event::PlayerDisconnectEvent>(
         [this](const ll::event::PlayerDisconnectEvent& event) {
             const auto& player = event.self();
             const auto  uuid   = player.getUuid().asString();
+            mPermManager->cancelWarmUp(uuid);
             mPermManager->invalidatePlayer(uuid);
         }
     );
 
     commands::registerCommands();
 
+    if (const auto& sync = config::config.Sync; sync.PollIntervalMillis > 0) {
+        // A database outage would fail every poll; log when it starts and when it ends.
+        mChangePoller = std::make_unique<utils::thread::PeriodicTask>(
+            std::chrono::milliseconds(sync.PollIntervalMillis),
+            [manager = mPermManager, failing = false]() mutable {
+                try {
+                    manager->syncRemoteChanges();
+                    if (std::exchange(failing, false)) logger.info("{}", "bakaperms.sync.resumed"_tr());
+                } catch (const std::exception& e) {
+                    if (!std::exchange(failing, true)) logger.warn("{}", "bakaperms.sync.poll_failed"_tr(e.what()));
+                }
+            }
+        );
+    }
+    if (const auto& sync = config::config.Sync; sync.TrimIntervalSeconds > 0) {
+        mChangeLogTrimmer = std::make_unique<utils::thread::PeriodicTask>(
+            std::chrono::seconds(sync.TrimIntervalSeconds),
+            [manager = mPermManager, retention = std::chrono::seconds(std::max(sync.LogRetentionSeconds, 1))] {
+                try {
+                    manager->trimChangeLog(retention);
+                } catch (const std::exception& e) {
+                    logger.warn("{}", "bakaperms.sync.trim_failed"_tr(e.what()));
+                }
+            }
+        );
+    }
+
+    if (const auto& metrics = config::config.Metrics; metrics.ExportIntervalSeconds > 0) {
+        mMetricsExporter = std::make_unique<utils::thread::PeriodicTask>(
+            std::chrono::seconds(metrics.ExportIntervalSeconds),
+            [manager = mPermManager, path = getSelf().getDataDir() / metrics.ExportFile] {
+                try {
+                    writeMetrics(*manager, path);
+                } catch (const std::exception& e) {
+                    logger.warn("{}", "bakaperms.metrics.export_failed"_tr(e.what()));
+                }
+            }
+        );
+    }
+
     return true;
 }
 
 bool BakaPerms::disable() {
+    mMetricsExporter.reset();
+    mChangePoller.reset();
+    mChangeLogTrimmer.reset();
+
     // Unregister permission service
     ll::service::ServiceManager::getInstance().unregisterService(core::IPermissionManager::ServiceId);
 
     auto& eventBus = ll::event::EventBus::getInstance();
 
+    if (mPlayerJoinListener) {
+        eventBus.removeListener(mPlayerJoinListener);
+        mPlayerJoinListener = nullptr;
+    }
+
     if (mPlayerDisconnectListener) {
         eventBus.removeListener(mPlayerDisconnectListener);
         mPlayerDisconnectListener = nullptr;
     }
 
     if (mPermManager) {
+        mPermManager->cancelAudit();
+        if (const auto limit = config::config.Performance.PersistedDecisions; limit > 0) {
+            try {
+                core::hot_decision_file::save(
+                    getSelf().getDataDir() / kHotDecisionsFile,
+                    mPermManager->exportHotDecisions(static_cast<std::size_t>(limit))
+                );
+            } catch (const std::exception& e) {
+                logger.warn("{}", "bakaperms.cache.save_failed"_tr(e.what()));
+            }
+        }
         mPermManager->invalidateAll();
     }
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "BakaPerms/Core/PermissionManager.hpp"
 #include "BakaPerms/Utils/Macros.h"
+#include "BakaPerms/Utils/Thread/PeriodicTask.hpp"
 
 #include <ll/api/event/ListenerBase.h>
 #include <ll/api/mod/NativeMod.h>
@@ -26,9 +27,13 @@ class BakaPerms {
     bool unload();
 
 private:
-    ll::mod::NativeMod&                      mSelf;
-    std::shared_ptr<core::PermissionManager> mPermManager;
-    ll::event::ListenerPtr                   mPlayerDisconnectListener;
+    ll::mod::NativeMod&                          mSelf;
+    std::shared_ptr<core::PermissionManager>     mPermManager;
+    ll::event::ListenerPtr                       mPlayerJoinListener;
+    ll::event::ListenerPtr                       mPlayerDisconnectListener;
+    std::unique_ptr<utils::thread::PeriodicTask> mMetricsExporter;
+    std::unique_ptr<utils::thread::PeriodicTask> mChangePoller;
+    std::unique_ptr<utils::thread::PeriodicTask> mChangeLogTrimmer;
 };
 
 } // namespace BakaPerms
@@ -3,6 +3,7 @@
 #include "BakaPerms/BakaPerms.hpp"
 #include "BakaPerms/Core/Types.hpp"
 #include "BakaPerms/Utils/I18n/I18n.hpp"
+#include "BakaPerms/Utils/Metrics/Metrics.hpp"
 
 #include <ll/api/command/CommandHandle.h>
 #include <ll/api/command/CommandRegistrar.h>
@@ -13,7 +14,11 @@
 #include <mc/server/commands/CommandOutput.h>
 #include <mc/server/commands/CommandPermissionLevel.h>
 
+#include <algorithm>
+#include <filesystem>
 #include <format>
+#include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
 
@@ -24,6 +29,18 @@ namespace BakaPerms::commands {
 // Command parameter structs
 struct ReloadParams {};
 
+struct StatsParams {};
+
+struct TransferParams {
+    enum { jsonl, binary } format{};
+    std::string file;
+};
+
+struct AuditParams {
+    enum { csv, jsonl } format{};
+    std::string file;
+};
+
 struct GroupCreateParams {
     std::string name;
 };
@@ -102,6 +119,27 @@ static auto resolvePlayerUuid(const std::string& playerName, CommandOutput& outp
     return info->uuid.asString();
 }
 
+// A command's file argument resolved inside the data directory. Paths that resolve outside it, whether
+// absolute or through ".." or a symlink, are refused so a command cannot touch files elsewhere.
+static auto resolveDataFile(const std::string& file, CommandOutput& output) -> std::optional<std::filesystem::path> {
+    try {
+        const auto dataDir = std::filesystem::weakly_canonical(BakaPerms::getInstance().getSelf().getDataDir());
+        const auto path    = std::filesystem::weakly_canonical(dataDir / file);
+        const auto rest    = path.lexically_relative(dataDir);
+        if (!rest.empty() && rest != "." && *rest.begin() != "..") return path;
+    } catch (const std::filesystem::filesystem_error&) {}
+    output.error("bakaperms.error.path_outside_data_dir"_tr(file));
+    return std::nullopt;
+}
+
+static auto toTransferFormat(const TransferParams& params) -> core::TransferFormat {
+    return params.format == TransferParams::binary ? core::TransferFormat::Binary : core::TransferFormat::JsonLines;
+}
+
+static auto toAuditFormat(const AuditParams& params) -> core::AuditFormat {
+    return params.format == AuditParams::csv ? core::AuditFormat::Csv : core::AuditFormat::JsonLines;
+}
+
 static auto accessMaskToString(const core::AccessMask mask) -> std::string {
     switch (mask) {
     case core::AccessMask::Allow:
@@ -175,8 +213,12 @@ static auto formatTrace(const core::PermissionTrace& trace, core::IPermissionMan
     bool anyAclFound = false;
     bool matched     = false;
 
-    for (const auto& [node, aclFound, acl, matchedAceIdx, matchedTokenKind] : trace.steps) {
-        msg += std::format("\n    {}", "bakaperms.trace.searching"_tr(node));
+    for (const auto& [node, pattern, aclFound, acl, matchedAceIdx, matchedTokenKind] : trace.steps) {
+        if (pattern) {
+            msg += std::format("\n    {}", "bakaperms.trace.pattern_matched"_tr(node, trace.requestedNode));
+        } else {
+            msg += std::format("\n    {}", "bakaperms.trace.searching"_tr(node));
+        }
 
         if (!aclFound) {
             msg += std::format("\n        {}", "bakaperms.trace.no_acl"_tr(node));
@@ -243,6 +285,102 @@ static auto formatTrace(const core::PermissionTrace& trace, core::IPermissionMan
     return msg;
 }
 
+static auto toMillis(const double ns) -> std::string { return std::format("{:.3f}", ns / 1e6); }
+
+// One line of at most `maxLength` characters, for statements written across several lines.
+static auto compactSql(const std::string_view sql, const std::size_t maxLength) -> std::string {
+    std::string line;
+    for (const char c : sql) {
+        const bool space = c == ' ' || c == '\n' || c == '\t' || c == '\r';
+        if (space && (line.empty() || line.back() == ' ')) continue;
+        line += space ? ' ' : c;
+    }
+    if (!line.empty() && line.back() == ' ') line.pop_back();
+    if (line.size() > maxLength) line.replace(maxLength - 3, std::string::npos, "...");
+    return line;
+}
+
+static auto formatStatementProfiles(const std::vector<database::StatementProfile>& profiles) -> std::string {
+    constexpr std::size_t kShown = 10;
+    if (profiles.empty()) return "bakaperms.stats.sql_empty"_tr();
+
+    const auto  shown = std::min(profiles.size(), kShown);
+    std::string msg   = "bakaperms.stats.sql_header"_tr(shown, profiles.size());
+    for (const auto& [sql, calls, totals, slowest] : std::span(profiles).first(shown)) {
+        msg += std::format(
+            "\n    {}",
+            "bakaperms.stats.sql_entry"_tr(
+                toMillis(static_cast<double>(totals.total().count())),
+                calls,
+                toMillis(static_cast<double>(totals.lockWait.count())),
+                toMillis(static_cast<double>(totals.prepare.count())),
+                toMillis(static_cast<double>(totals.step.count())),
+                toMillis(static_cast<double>(totals.extract.count())),
+                toMillis(static_cast<double>(slowest.count())),
+                totals.rows,
+                compactSql(sql, 120)
+            )
+        );
+    }
+    return msg;
+}
+
+// Renders collected metrics as chat lines; empty latency histograms are left out.
+class StatsFormatter final : public utils::metrics::MetricVisitor {
+public:
+    void counter(
+        const std::string_view name,
+        const std::string_view,
+        const std::string_view labels,
+        const std::uint64_t    value
+    ) override {
+        if (name == "bakaperms_cache_hits_total") hits_ = value;
+        if (name == "bakaperms_cache_misses_total") misses_ = value;
+        lines_ += std::format("\n    {}", "bakaperms.stats.value"_tr(label(name, labels), value));
+    }
+
+    void gauge(const std::string_view name, const std::string_view, const std::string_view labels, const double value)
+        override {
+        lines_ += std::format("\n    {}", "bakaperms.stats.value"_tr(label(name, labels), value));
+    }
+
+    void histogram(
+        const std::string_view                   name,
+        const std::string_view,
+        const std::string_view                   labels,
+        const utils::metrics::HistogramSnapshot& value
+    ) override {
+        if (value.count == 0) return;
+        const auto mean = static_cast<double>(value.sumNs) / static_cast<double>(value.count);
+        lines_         += std::format(
+            "\n    {}",
+            "bakaperms.stats.latency"_tr(
+                label(name, labels),
+                value.count,
+                toMillis(mean),
+                toMillis(static_cast<double>(value.quantile(0.5).count())),
+                toMillis(static_cast<double>(value.quantile(0.99).count()))
+            )
+        );
+    }
+
+    [[nodiscard]] auto str() const -> std::string {
+        const auto total    = hits_ + misses_;
+        const auto ratio    = total == 0 ? 0.0 : 100.0 * static_cast<double>(hits_) / static_cast<double>(total);
+        const auto hitRatio = "bakaperms.stats.hit_ratio"_tr(std::format("{:.1f}", ratio), hits_, misses_);
+        return std::format("{}\n    {}{}", "bakaperms.stats.header"_tr(), hitRatio, lines_);
+    }
+
+private:
+    static auto label(const std::string_view name, const std::string_view labels) -> std::string {
+        return labels.empty() ? std::string(name) : std::format("{}{{{}}}", name, labels);
+    }
+
+    std::string   lines_;
+    std::uint64_t hits_{0};
+    std::uint64_t misses_{0};
+};
+
 // Registration
 void registerCommands() {
     auto& command = ll::command::CommandRegistrar::getInstance(false)
@@ -251,10 +389,90 @@ void registerCommands() {
     // /perms reload
     command.overload<ReloadParams>().text("reload").execute([](CommandOrigin const&, CommandOutput& output) {
         auto& mgr = BakaPerms::getInstance().getPermissionManager();
-        mgr.invalidateAll();
-        output.success("bakaperms.reload.success"_tr());
+        try {
+            mgr.reload();
+            output.success("bakaperms.reload.success"_tr());
+        } catch (const std::exception& e) {
+            output.error("bakaperms.error.operation_failed"_tr(e.what()));
+        }
     });
 
+    // /perms stats
+    command.overload<StatsParams>().text("stats").execute([](CommandOrigin const&, CommandOutput& output) {
+        const auto&    mgr = BakaPerms::getInstance().getPermissionManager();
+        StatsFormatter formatter;
+        try {
+            mgr.collectMetrics(formatter);
+            output.success(formatter.str());
+        } catch (const std::exception& e) {
+            output.error("bakaperms.error.operation_failed"_tr(e.what()));
+        }
+    });
+
+    // /perms stats sql
+    command.overload<StatsParams>().text("stats").text("sql").execute([](CommandOrigin const&, CommandOutput& output) {
+        const auto& mgr = BakaPerms::getInstance().getPermissionManager();
+        try {
+            output.success(formatStatementProfiles(mgr.getStatementProfiles()));
+        } catch (const std::exception& e) {
+            output.error("bakaperms.error.operation_failed"_tr(e.what()));
+        }
+    });
+
+    // Bulk transfer; files are relative to the mod's data directory
+    // /perms export <jsonl|binary> <file>
+    command.overload<TransferParams>().text("export").required("format").required("file").execute(
+        [](CommandOrigin const&, CommandOutput& output, const TransferParams& params) {
+            const auto& mgr  = BakaPerms::getInstance().getPermissionManager();
+            const auto  path = resolveDataFile(params.file, output);
+            if (!path) return;
+            try {
+                const auto stats = mgr.exportData(*path, toTransferFormat(params));
+                output.success(
+                    "bakaperms.transfer.exported"_tr(stats.groups, stats.memberships, stats.aces, path->string())
+                );
+            } catch (const std::exception& e) {
+                output.error("bakaperms.error.operation_failed"_tr(e.what()));
+            }
+        }
+    );
+
+    // /perms import <jsonl|binary> <file>
+    command.overload<TransferParams>().text("import").required("format").required("file").execute(
+        [](CommandOrigin const&, CommandOutput& output, const TransferParams& params) {
+            auto&      mgr  = BakaPerms::getInstance().getPermissionManager();
+            const auto path = resolveDataFile(params.file, output);
+            if (!path) return;
+            try {
+                if (mgr.startImport(*path, toTransferFormat(params))) {
+                    output.success("bakaperms.transfer.import_started"_tr(path->string()));
+                } else {
+                    output.error("bakaperms.transfer.import_running"_tr());
+                }
+            } catch (const std::exception& e) {
+                output.error("bakaperms.error.operation_failed"_tr(e.what()));
+            }
+        }
+    );
+
+    // /perms audit <csv|jsonl> <file>
+    command.overload<AuditParams>().text("audit").required("format").required("file").execute(
+        [](CommandOrigin const&, CommandOutput& output, const AuditParams& params) {
+            auto&      mgr  = BakaPerms::getInstance().getPermissionManager();
+            const auto path = resolveDataFile(params.file, output);
+            if (!path) return;
+            try {
+                if (mgr.startAudit(*path, toAuditFormat(params))) {
+                    output.success("bakaperms.audit.started"_tr(path->string()));
+                } else {
+                    output.error("bakaperms.audit.already_running"_tr());
+                }
+            } catch (const std::exception& e) {
+                output.error("bakaperms.error.operation_failed"_tr(e.what()));
+            }
+        }
+    );
+
     // Group management
     // /perms group create <name>
     command.overload<GroupCreateParams>()
@@ -3,6 +3,7 @@
 #include <ll/api/Config.h>
 
 #include <string>
+#include <vector>
 
 namespace BakaPerms::config {
 
@@ -17,16 +18,43 @@ struct ConfigV1 {
     struct Database {
         std::string Type = "sqlite"; // "sqlite" or "postgresql"
         struct SQLite {
-            std::string Path = "permissions.db"; // relative path from dataDir, or absolute
+            std::string Path                        = "permissions.db"; // relative path from dataDir, or absolute
+            int         StatementCacheSize          = 64;               // prepared statements kept per connection
+            int         ReadConnections             = 4;                // pooled read-only connections, 0 to disable
+            int         SlowQueryMillis             = 100;              // log statements slower than this, 0 to disable
+            int         SlowQueryLogIntervalSeconds = 10;               // at most one slow-query log per interval
         } SQLite;
         struct PostgreSQL {
-            std::string Host     = "localhost";
-            int         Port     = 5432;
-            std::string Username = "postgres";
+            std::string Host                        = "localhost";
+            int         Port                        = 5432;
+            std::string Username                    = "postgres";
             std::string Password;
-            std::string Database = "baka_perms";
+            std::string Database                    = "baka_perms";
+            std::string SSLMode                     = "prefer"; // libpq sslmode
+            int         ConnectTimeoutSeconds       = 10;
+            int         StatementCacheSize          = 64;       // prepared statements kept per connection
+            int         ReadConnections             = 4;        // pooled read-only connections, 0 to disable
+            int         SlowQueryMillis             = 100;      // log statements slower than this, 0 to disable
+            int         SlowQueryLogIntervalSeconds = 10;       // at most one slow-query log per interval
         } PostgreSQL;
     } Database;
+    struct Performance {
+        int                      AsyncWorkerThreads = 2;     // threads resolving async checks and join warm-ups
+        std::vector<std::string> WarmUpNodes;                // nodes pre-resolved for every joining player
+        int                      LearnedWarmUpNodes = 32;    // plus this many of the most frequently missed nodes
+        int                      PersistedDecisions = 20000; // hot decisions kept across restarts, 0 to disable
+        bool                     SnapshotImage      = true;  // answer checks from a mapped image while loading
+        int                      AuditThreads       = 0;     // /perms audit workers, 0 for one per hardware thread
+    } Performance;
+    struct Sync {
+        int PollIntervalMillis  = 500;  // apply other servers' edits from the change log, 0 to disable
+        int LogRetentionSeconds = 3600; // change log entries older than this are trimmed
+        int TrimIntervalSeconds = 300;  // how often to trim, 0 to disable
+    } Sync;
+    struct Metrics {
+        int         ExportIntervalSeconds = 0;              // write metrics every N seconds, 0 to disable
+        std::string ExportFile            = "metrics.prom"; // Prometheus text format; relative to dataDir
+    } Metrics;
 };
 
 using Config = ConfigV1;
@@ -0,0 +1,112 @@
+#include "BakaPerms/Core/HotDecisionFile.hpp"
+
+#include "BakaPerms/Utils/Exception/Exceptions.hpp"
+#include "BakaPerms/Utils/IO/BinaryStream.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+namespace BakaPerms::core::hot_decision_file {
+
+// Layout (little-endian, as written by the host):
+//   magic "BPHD", u32 version, u64 fingerprint,
+//   u32 n + n × (u32 len, bytes)   token signatures
+//   u32 n + n × (u32 len, bytes)   nodes
+//   u32 n + n × (u32, u32, u8)     entries
+//   u32 n + n × (u32, u32)         demand
+constexpr char          kMagic[4] = {'B', 'P', 'H', 'D'};
+constexpr std::uint32_t kVersion  = 2;
+
+constexpr std::uint32_t kMaxStringSize = 1 << 16; // nodes and group-uuid lists; anything larger means corruption
+
+namespace {
+
+void writeStrings(utils::io::BinaryWriter& out, const std::vector<std::string>& strings) {
+    out.write(static_cast<std::uint32_t>(strings.size()));
+    for (const auto& str : strings) {
+        out.writeString(str);
+    }
+}
+
+bool readStrings(utils::io::BinaryReader& in, std::vector<std::string>& strings) {
+    std::uint32_t count = 0;
+    if (!in.read(count)) return false;
+    strings.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        if (!in.readString(strings.emplace_back(), kMaxStringSize)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+void save(const std::filesystem::path& path, const HotDecisions& decisions) {
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream           file(tmpPath, std::ios::binary | std::ios::trunc);
+        utils::io::BinaryWriter out(file);
+        out.write(kMagic);
+        out.write(kVersion);
+        out.write(decisions.fingerprint);
+        writeStrings(out, decisions.signatures);
+        writeStrings(out, decisions.nodes);
+        out.write(static_cast<std::uint32_t>(decisions.entries.size()));
+        for (const auto& entry : decisions.entries) {
+            out.write(entry.signature);
+            out.write(entry.node);
+            out.write(static_cast<std::uint8_t>(entry.mask));
+        }
+        out.write(static_cast<std::uint32_t>(decisions.demand.size()));
+        for (const auto& demand : decisions.demand) {
+            out.write(demand.node);
+            out.write(demand.count);
+        }
+        if (!file.flush()) {
+            throw utils::exception::OperationFailedException("Failed to write " + tmpPath.string());
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        throw utils::exception::OperationFailedException("Failed to replace " + path.string() + ": " + ec.message());
+    }
+}
+
+auto load(const std::filesystem::path& path) -> std::optional<HotDecisions> {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return std::nullopt;
+    utils::io::BinaryReader in(file);
+
+    char          magic[sizeof(kMagic)]{};
+    std::uint32_t version = 0;
+    HotDecisions  decisions;
+    if (!in.read(magic) || !std::equal(std::begin(magic), std::end(magic), kMagic)) return std::nullopt;
+    if (!in.read(version) || version != kVersion) return std::nullopt;
+    if (!in.read(decisions.fingerprint)) return std::nullopt;
+    if (!readStrings(in, decisions.signatures) || !readStrings(in, decisions.nodes)) return std::nullopt;
+
+    std::uint32_t count = 0;
+    if (!in.read(count)) return std::nullopt;
+    decisions.entries.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        HotDecisions::Entry entry{};
+        std::uint8_t        mask = 0;
+        if (!in.read(entry.signature) || !in.read(entry.node) || !in.read(mask)) return std::nullopt;
+        if (entry.signature >= decisions.signatures.size() || entry.node >= decisions.nodes.size()) return std::nullopt;
+        entry.mask = static_cast<AccessMask>(mask);
+        decisions.entries.push_back(entry);
+    }
+
+    if (!in.read(count)) return std::nullopt;
+    decisions.demand.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        HotDecisions::Demand demand{};
+        if (!in.read(demand.node) || !in.read(demand.count)) return std::nullopt;
+        if (demand.node >= decisions.nodes.size()) return std::nullopt;
+        decisions.demand.push_back(demand);
+    }
+    return decisions;
+}
+
+} // namespace BakaPerms::core::hot_decision_file
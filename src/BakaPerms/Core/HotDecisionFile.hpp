@@ -0,0 +1,43 @@
+#pragma once
+#include "BakaPerms/Core/Types.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace BakaPerms::core {
+
+/// Decisions worth keeping across a restart, tagged with the fingerprint of the data they were
+/// resolved against. Token signatures and nodes are interned; entries refer to them by index.
+struct HotDecisions {
+    struct Entry {
+        std::uint32_t signature;
+        std::uint32_t node;
+        AccessMask    mask;
+    };
+
+    struct Demand {
+        std::uint32_t node;
+        std::uint32_t count;
+    };
+
+    std::uint64_t            fingerprint{0};
+    std::vector<std::string> signatures; // see PermissionManager::tokenSignature
+    std::vector<std::string> nodes;
+    std::vector<Entry>       entries;
+    std::vector<Demand>      demand; // learned warm-up counters
+};
+
+namespace hot_decision_file {
+
+/// Write `decisions` atomically (temp file + rename). Throws OperationFailedException on I/O errors.
+void save(const std::filesystem::path& path, const HotDecisions& decisions);
+
+/// Read a file written by save(). Returns nullopt if it is missing, truncated or from another format version.
+[[nodiscard]] auto load(const std::filesystem::path& path) -> std::optional<HotDecisions>;
+
+} // namespace hot_decision_file
+
+} // namespace BakaPerms::core
@@ -1,15 +1,23 @@
 #pragma once
 #include "BakaPerms/Core/Types.hpp"
+#include "BakaPerms/Database/DbTypes.hpp"
+#include "BakaPerms/Utils/Metrics/Metrics.hpp"
 
 #include <ll/api/service/Service.h>
 
+#include <filesystem>
+#include <functional>
+#include <future>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
 
 namespace BakaPerms::core {
 
+/// Exported as a service: consumer mods call through this vtable by slot, so new virtual functions are
+/// only ever appended at the end, never inserted between existing ones.
 class IPermissionManager : public ll::service::ServiceImpl<IPermissionManager, 1> {
 public:
     ~IPermissionManager() override = default;
@@ -49,6 +57,45 @@ class IPermissionManager : public ll::service::ServiceImpl<IPermissionManager, 1
     // Cache
     virtual void invalidatePlayer(std::string_view uuid) = 0;
     virtual void invalidateAll()                         = 0;
+    virtual void reload()                                = 0; // Re-read everything from the database
+    virtual void warmUpPlayer(std::string_view uuid)     = 0; // Pre-resolve hot nodes in the background
+
+    // Metrics: cache, resolution, invalidation and database counters, and per-SQL-text timings
+    virtual void collectMetrics(utils::metrics::MetricVisitor& visitor) const            = 0;
+    virtual auto getStatementProfiles() const -> std::vector<database::StatementProfile> = 0;
+
+    // Batch checks
+    /// Check many nodes for one player; results are in the same order as `nodes`.
+    virtual auto checkPermissions(std::string_view playerUuid, std::span<const std::string_view> nodes)
+        -> std::vector<AccessMask> = 0;
+    /// Return the players (in input order) that are allowed `node`.
+    virtual auto filterPlayersWithPermission(std::string_view node, std::span<const std::string_view> playerUuids)
+        -> std::vector<std::string> = 0;
+
+    // Asynchronous checks
+    /// Non-blocking check: cache hits complete inline, misses are resolved on a background thread.
+    virtual auto checkPermissionAsync(std::string_view playerUuid, std::string_view node)
+        -> std::future<AccessMask> = 0;
+    /// Callback flavour. `callback` runs exactly once: on the server thread for ServerThread, cache hit
+    /// or not; for WorkerThread, inline on a hit. A check that fails is logged and delivered as Deny.
+    virtual void checkPermissionAsync(
+        std::string_view                playerUuid,
+        std::string_view                node,
+        std::function<void(AccessMask)> callback,
+        AsyncDelivery                   delivery
+    ) = 0;
+
+    // Bulk transfer (see data::PermissionTransfer for the merge rules)
+    virtual auto exportData(const std::filesystem::path& path, TransferFormat format) const -> TransferStats = 0;
+    virtual auto importData(const std::filesystem::path& path, TransferFormat format) -> TransferStats       = 0;
+
+    // Audit (see PermissionAudit): writes every subject's access on every ACL node to `path` on a
+    // background thread and logs the outcome. Returns false if an audit is already running.
+    virtual bool startAudit(const std::filesystem::path& path, AuditFormat format) = 0;
+
+    // importData() on a background thread, logging the outcome. Returns false if an import is already
+    // running. Checks keep being answered meanwhile; edits wait for the import to finish.
+    virtual bool startImport(const std::filesystem::path& path, TransferFormat format) = 0;
 };
 
 } // namespace BakaPerms::core
@@ -0,0 +1,175 @@
+#include "BakaPerms/Core/NodePattern.hpp"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+
+namespace BakaPerms::core {
+
+// Ordered by precedence; the end of a node ranks below every segment.
+enum class SegmentKind : std::uint8_t { End, GlobStar, Star, Literal };
+
+static auto segmentKind(const std::string_view segment) -> SegmentKind {
+    if (segment == "**") return SegmentKind::GlobStar;
+    if (segment == "*") return SegmentKind::Star;
+    return SegmentKind::Literal;
+}
+
+static auto splitSegments(const std::string_view node) -> std::vector<std::string_view> {
+    std::vector<std::string_view> segments;
+    for (std::size_t begin = 0;;) {
+        const auto end = node.find('.', begin);
+        segments.push_back(node.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin));
+        if (end == std::string_view::npos) break;
+        begin = end + 1;
+    }
+    return segments;
+}
+
+auto NodePatternMatcher::isPattern(const std::string_view node) -> bool {
+    return node != "*" && literalPrefix(node).size() != node.size();
+}
+
+auto NodePatternMatcher::literalPrefix(const std::string_view node) -> std::string_view {
+    if (node == "*") return node;
+    for (std::size_t begin = 0;;) {
+        const auto end     = node.find('.', begin);
+        const auto segment = node.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+        if (segmentKind(segment) != SegmentKind::Literal) return node.substr(0, begin == 0 ? 0 : begin - 1);
+        if (end == std::string_view::npos) return node;
+        begin = end + 1;
+    }
+}
+
+NodePatternMatcher::NodePatternMatcher(std::vector<std::string> patterns) : patterns_(std::move(patterns)) {
+    if (patterns_.empty()) return;
+
+    // Rank patterns by their segment kinds, left to right; ties (patterns of the same shape that
+    // match one node through different "**" splits) go to the lexicographically smaller pattern.
+    std::vector<std::vector<SegmentKind>> kinds(patterns_.size());
+    literalSegments_.resize(patterns_.size());
+    for (std::size_t id = 0; id < patterns_.size(); ++id) {
+        for (const auto segment : splitSegments(patterns_[id])) kinds[id].push_back(segmentKind(segment));
+        const auto firstWildcard = std::ranges::find_if(kinds[id], [](const SegmentKind kind) {
+            return kind != SegmentKind::Literal;
+        });
+        literalSegments_[id] = static_cast<std::uint32_t>(firstWildcard - kinds[id].begin());
+    }
+    std::vector<PatternId> order(patterns_.size());
+    std::iota(order.begin(), order.end(), PatternId{0});
+    std::ranges::sort(order, [&](const PatternId a, const PatternId b) {
+        if (const auto cmp = kinds[a] <=> kinds[b]; cmp != 0) return cmp < 0;
+        return patterns_[a] > patterns_[b];
+    });
+    ranks_.resize(patterns_.size());
+    for (std::size_t rank = 0; rank < order.size(); ++rank) ranks_[order[rank]] = static_cast<std::uint32_t>(rank);
+
+    // NFA: a trie over pattern segments. A "**" node consumes its first segment on entry and loops on
+    // every further one.
+    struct NfaNode {
+        StringMap<std::uint32_t> literal;
+        std::uint32_t            star{kDead};
+        std::uint32_t            globStar{kDead};
+        bool                     loops{false};
+        PatternId                accept{kNoMatch};
+    };
+    std::vector<NfaNode> nfa(1);
+    for (PatternId id = 0; id < patterns_.size(); ++id) {
+        std::uint32_t current = 0;
+        for (const auto segment : splitSegments(patterns_[id])) {
+            const auto    kind = segmentKind(segment);
+            std::uint32_t next = kDead;
+            if (kind == SegmentKind::Literal) {
+                auto& literal = nfa[current].literal;
+                if (const auto it = literal.find(segment); it != literal.end()) next = it->second;
+            } else {
+                next = kind == SegmentKind::Star ? nfa[current].star : nfa[current].globStar;
+            }
+            if (next == kDead) {
+                next = static_cast<std::uint32_t>(nfa.size());
+                nfa.push_back({.literal = {}, .loops = kind == SegmentKind::GlobStar});
+                if (kind == SegmentKind::Literal) {
+                    nfa[current].literal.emplace(segment, next);
+                } else if (kind == SegmentKind::Star) {
+                    nfa[current].star = next;
+                } else {
+                    nfa[current].globStar = next;
+                }
+            }
+            current = next;
+        }
+        nfa[current].accept = id;
+    }
+
+    // Subset construction. Each DFA state is the set of NFA nodes reachable by the segments read so far;
+    // its transitions are the literal segments any member knows plus one shared edge for every other segment.
+    std::map<std::vector<std::uint32_t>, std::uint32_t> ids;
+    std::vector<std::vector<std::uint32_t>>             sets;
+
+    const auto intern = [&](std::vector<std::uint32_t> set) {
+        std::ranges::sort(set);
+        set.erase(std::ranges::unique(set).begin(), set.end());
+        if (set.empty()) return kDead;
+        const auto [it, inserted] = ids.try_emplace(set, static_cast<std::uint32_t>(states_.size()));
+        if (inserted) {
+            auto& state = states_.emplace_back();
+            for (const auto member : set) {
+                const auto accept = nfa[member].accept;
+                if (accept != kNoMatch && (state.accept == kNoMatch || ranks_[accept] > ranks_[state.accept])) {
+                    state.accept = accept;
+                }
+            }
+            sets.push_back(std::move(set));
+        }
+        return it->second;
+    };
+
+    intern({0});
+    for (std::size_t current = 0; current < sets.size(); ++current) {
+        std::vector<std::uint32_t>            wildcard;
+        StringMap<std::vector<std::uint32_t>> literal;
+        const std::vector<std::uint32_t>      members = sets[current]; // copied, intern() appends to `sets`
+        for (const auto member : members) {
+            const auto& node = nfa[member];
+            if (node.star != kDead) wildcard.push_back(node.star);
+            if (node.globStar != kDead) wildcard.push_back(node.globStar);
+            if (node.loops) wildcard.push_back(member);
+            for (const auto& [segment, child] : node.literal) literal[segment].push_back(child);
+        }
+        for (auto& [segment, targets] : literal) {
+            targets.insert(targets.end(), wildcard.begin(), wildcard.end());
+            const auto next = intern(std::move(targets));
+            states_[current].next.emplace(segment, next);
+        }
+        const auto other       = intern(std::move(wildcard));
+        states_[current].other = other;
+    }
+}
+
+auto NodePatternMatcher::match(const std::string_view node) const -> Match {
+    Match best;
+    if (states_.empty()) return best;
+
+    std::uint32_t current = 0;
+    for (std::size_t begin = 0;;) {
+        const auto end     = node.find('.', begin);
+        const auto segment = node.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+
+        const auto& state = states_[current];
+        const auto  it    = state.next.find(segment);
+        current           = it != state.next.end() ? it->second : state.other;
+        if (current == kDead) break;
+
+        // Every prefix of `node` is an ancestor the accepted pattern applies to; keep the best.
+        if (const auto accept = states_[current].accept;
+            accept != kNoMatch && (best.id == kNoMatch || ranks_[accept] > ranks_[best.id])) {
+            best = {.id = accept, .literalSegments = literalSegments_[accept]};
+        }
+
+        if (end == std::string_view::npos) break;
+        begin = end + 1;
+    }
+    return best;
+}
+
+} // namespace BakaPerms::core
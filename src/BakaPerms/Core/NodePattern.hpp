@@ -0,0 +1,75 @@
+#pragma once
+#include "BakaPerms/Core/Types.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BakaPerms::core {
+
+/// Wildcard permission nodes compiled into one segment-level DFA. A "*" segment matches exactly one
+/// segment and "**" matches one or more, so `plots.*.build` covers `plots.12.build`. The root wildcard
+/// "*" on its own is not a pattern; it keeps its meaning as the ACL every node falls back to.
+///
+/// Like a literal ACL, a pattern applies to the nodes it matches and to their descendants. When several
+/// ACLs apply, their segments are compared left to right and the first difference decides: a literal
+/// segment outranks "*", "*" outranks "**", and any segment outranks the end of the node. For literal
+/// nodes alone this is the usual nearest-ancestor rule; `plots.*.build` beats `plots`, but `plots.12`
+/// beats `plots.*.build`.
+///
+/// Immutable once built. match() is one hash probe per segment, however many patterns are compiled.
+class NodePatternMatcher {
+public:
+    using PatternId = std::uint32_t;
+
+    static constexpr PatternId kNoMatch = std::numeric_limits<PatternId>::max();
+
+    struct Match {
+        PatternId     id{kNoMatch};
+        std::uint32_t literalSegments{0}; // segments before the pattern's first wildcard
+    };
+
+    /// True if a segment of `node` is "*" or "**", other than the root wildcard "*" itself.
+    static auto isPattern(std::string_view node) -> bool;
+
+    /// `node` up to its first wildcard segment, without the trailing dot; `node` itself if it is not a
+    /// pattern. Every node a pattern applies to lies under this prefix, which is empty for e.g. `*.build`.
+    static auto literalPrefix(std::string_view node) -> std::string_view;
+
+    /// True if a pattern with `literalSegments` leading literal segments outranks a literal ACL `depth`
+    /// segments deep (0 for the root wildcard), both applying to the same node.
+    static constexpr auto outranksLiteral(const std::uint32_t literalSegments, const std::uint32_t depth) -> bool {
+        return literalSegments >= depth;
+    }
+
+    NodePatternMatcher() = default;
+
+    /// Compile `patterns`, each of which must satisfy isPattern(). Ids are indices into the vector.
+    explicit NodePatternMatcher(std::vector<std::string> patterns);
+
+    /// Highest-ranked pattern matching `node` or one of its ancestors.
+    [[nodiscard]] auto match(std::string_view node) const -> Match;
+
+    [[nodiscard]] auto pattern(const PatternId id) const -> std::string_view { return patterns_[id]; }
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return patterns_.size(); }
+    [[nodiscard]] auto empty() const noexcept -> bool { return patterns_.empty(); }
+    [[nodiscard]] auto stateCount() const noexcept -> std::size_t { return states_.size(); }
+
+private:
+    static constexpr std::uint32_t kDead = std::numeric_limits<std::uint32_t>::max();
+
+    struct State {
+        StringMap<std::uint32_t> next;             // segment → state
+        std::uint32_t            other{kDead};     // any segment not in `next`
+        PatternId                accept{kNoMatch}; // highest-ranked pattern ending here
+    };
+
+    std::vector<std::string>   patterns_;
+    std::vector<std::uint32_t> ranks_; // by pattern id, higher wins
+    std::vector<std::uint32_t> literalSegments_;
+    std::vector<State>         states_; // states_[0] is the start state
+};
+
+} // namespace BakaPerms::core
@@ -0,0 +1,122 @@
+#include "BakaPerms/Core/NodeTrie.hpp"
+
+namespace BakaPerms::core {
+
+void NodeTrie::assign(const std::string_view node, const ACL acl) {
+    if (node == "*") {
+        rootACL_ = acl;
+        return;
+    }
+    if (NodePatternMatcher::isPattern(node)) {
+        if (acl.empty()) {
+            if (patterns_.erase(node)) patternsChanged_ = true;
+        } else {
+            patterns_.set(std::string(node), acl);
+            patternsChanged_ = true;
+        }
+        return;
+    }
+    root_ = assign(root_, node, 0, acl);
+}
+
+auto NodeTrie::assign(const NodePtr& node, const std::string_view path, const std::size_t begin, const ACL acl)
+    -> NodePtr {
+    auto copy = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+    if (begin == std::string_view::npos) {
+        copy->acl = acl;
+    } else {
+        const auto  end     = path.find('.', begin);
+        const auto  segment = path.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+        const auto* child   = copy->children.find(segment);
+        const auto  next    = end == std::string_view::npos ? std::string_view::npos : end + 1;
+        if (auto updated = assign(child ? *child : nullptr, path, next, acl)) {
+            copy->children.set(std::string(segment), std::move(updated));
+        } else {
+            copy->children.erase(segment);
+        }
+    }
+    if (copy->acl.empty() && copy->children.empty()) return nullptr;
+    return copy;
+}
+
+void NodeTrie::compilePatterns() {
+    if (!patternsChanged_) return;
+    patternsChanged_ = false;
+    if (patterns_.empty()) {
+        compiled_.reset();
+        return;
+    }
+    auto                     compiled = std::make_shared<CompiledPatterns>();
+    std::vector<std::string> nodes;
+    nodes.reserve(patterns_.size());
+    compiled->acls.reserve(patterns_.size());
+    for (const auto& [pattern, acl] : patterns_) {
+        nodes.push_back(pattern);
+        compiled->acls.push_back(acl);
+    }
+    compiled->matcher = NodePatternMatcher(std::move(nodes));
+    compiled_         = std::move(compiled);
+}
+
+auto NodeTrie::findNearestACL(const std::string_view node) const -> ACL {
+    // The deepest ACL on the path the trie matches, falling back to "*" at depth 0.
+    auto          literal = rootACL_;
+    std::uint32_t depth   = 0;
+    std::uint32_t matched = 0;
+    const auto*   current = root_.get();
+    for (std::size_t begin = 0; current;) {
+        const auto  end     = node.find('.', begin);
+        const auto  segment = node.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+        const auto* child   = current->children.find(segment);
+        if (!child) break;
+        current = child->get();
+        ++matched;
+        if (!current->acl.empty()) {
+            literal = current->acl;
+            depth   = matched;
+        }
+
+        if (end == std::string_view::npos) break;
+        begin = end + 1;
+    }
+
+    if (!compiled_) return literal;
+    const auto match = compiled_->matcher.match(node);
+    if (match.id != NodePatternMatcher::kNoMatch && NodePatternMatcher::outranksLiteral(match.literalSegments, depth)) {
+        return compiled_->acls[match.id];
+    }
+    return literal;
+}
+
+auto NodeTrie::findPattern(const std::string_view node) const -> PatternHit {
+    if (!compiled_) return {};
+    const auto match = compiled_->matcher.match(node);
+    if (match.id == NodePatternMatcher::kNoMatch) return {};
+    return {
+        .acl             = compiled_->acls[match.id],
+        .pattern         = compiled_->matcher.pattern(match.id),
+        .literalSegments = match.literalSegments,
+    };
+}
+
+auto NodeTrie::findACL(const std::string_view node) const -> ACL {
+    if (node == "*") return rootACL_;
+    if (NodePatternMatcher::isPattern(node)) {
+        const auto* acl = patterns_.find(node);
+        return acl ? *acl : ACL{};
+    }
+    const auto* current = root_.get();
+    for (std::size_t begin = 0; current;) {
+        const auto  end     = node.find('.', begin);
+        const auto  segment = node.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+        const auto* child   = current->children.find(segment);
+        if (!child) return {};
+        current = child->get();
+
+        if (end == std::string_view::npos) return current->acl;
+        begin = end + 1;
+    }
+    return {};
+}
+
+} // namespace BakaPerms::core
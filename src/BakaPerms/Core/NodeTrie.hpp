@@ -0,0 +1,74 @@
+#pragma once
+#include "BakaPerms/Core/NodePattern.hpp"
+#include "BakaPerms/Core/PersistentStringMap.hpp"
+#include "BakaPerms/Core/Types.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BakaPerms::core {
+
+/// Interned permission-node registry. Dot-separated segments are stored once in a trie, and every
+/// ACL-bearing node carries a view of its ACL. Wildcard patterns are kept aside and compiled into a
+/// NodePatternMatcher by compilePatterns(). Trie nodes are immutable and shared between copies, so a
+/// copy is O(1) and assign() copies only the path to the edited node. Lookups never allocate.
+class NodeTrie {
+public:
+    using ACL = std::span<const ACE>; // empty: no ACL
+
+    struct PatternHit {
+        ACL              acl;
+        std::string_view pattern;
+        std::uint32_t    literalSegments{0};
+    };
+
+    /// Attach `acl` to `node`, or detach its ACL if `acl` is empty. `acl` is not copied and must outlive
+    /// every copy of the trie that holds it. The root wildcard "*" is stored separately; a pattern change
+    /// only takes effect after compilePatterns().
+    void assign(std::string_view node, ACL acl);
+
+    /// Recompile the patterns if assign() changed one since the last call; a no-op otherwise.
+    void compilePatterns();
+
+    /// Walk exact node → parent levels → "*" and return the first ACL found, or an empty span, unless a
+    /// wildcard pattern outranks it (see NodePatternMatcher). Without patterns this is equivalent to
+    /// probing every entry of PermissionResolver::buildNodePath(), without building it.
+    [[nodiscard]] auto findNearestACL(std::string_view node) const -> ACL;
+
+    /// Highest-ranked pattern matching `node` or one of its ancestors, whether or not it outranks the
+    /// nearest literal ACL.
+    [[nodiscard]] auto findPattern(std::string_view node) const -> PatternHit;
+
+    /// ACL attached to exactly `node`, literal or pattern, or an empty span.
+    [[nodiscard]] auto findACL(std::string_view node) const -> ACL;
+
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    struct Node {
+        ACL                          acl;
+        PersistentStringMap<NodePtr> children; // segment → child
+    };
+
+    struct CompiledPatterns {
+        NodePatternMatcher matcher;
+        std::vector<ACL>   acls; // by pattern id
+    };
+
+    /// `node` with the ACL at `path` from `begin` on replaced, or nullptr once it has neither an ACL
+    /// nor children. `begin` is npos when `node` itself is the target.
+    static auto assign(const NodePtr& node, std::string_view path, std::size_t begin, ACL acl) -> NodePtr;
+
+    NodePtr                                 root_;
+    ACL                                     rootACL_;  // ACL on "*"
+    PersistentStringMap<ACL>                patterns_; // pattern node → ACL
+    std::shared_ptr<const CompiledPatterns> compiled_;
+    bool                                    patternsChanged_{false};
+};
+
+} // namespace BakaPerms::core
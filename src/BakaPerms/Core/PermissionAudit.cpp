@@ -0,0 +1,209 @@
+#include "BakaPerms/Core/PermissionAudit.hpp"
+
+#include "BakaPerms/Core/PermissionResolver.hpp"
+#include "BakaPerms/Utils/Exception/Exceptions.hpp"
+#include "BakaPerms/Utils/Thread/ThreadPool.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+
+namespace BakaPerms::core {
+
+// Subjects each worker may run ahead of the writer.
+constexpr std::size_t kWindowPerThread = 4;
+
+static auto csvCell(const std::string_view value) -> std::string {
+    if (value.find_first_of(",\"\r\n") == std::string_view::npos) return std::string(value);
+    std::string cell = "\"";
+    for (const auto c : value) {
+        if (c == '"') cell += '"';
+        cell += c;
+    }
+    cell += '"';
+    return cell;
+}
+
+static auto jsonCell(const std::string_view value) -> std::string { return nlohmann::json(value).dump(); }
+
+PermissionAudit::PermissionAudit(std::shared_ptr<const PermissionSnapshot> snapshot) : snapshot_(std::move(snapshot)) {
+    std::vector<const GroupInfo*> groups;
+    groups.reserve(snapshot_->groups().size());
+    for (const auto& [uuid, group] : snapshot_->groups()) groups.push_back(&group);
+    std::ranges::sort(groups, {}, &GroupInfo::name);
+    for (const auto* group : groups) {
+        subjects_.push_back({.kind = SubjectKind::Group, .uuid = group->uuid, .name = group->name});
+    }
+
+    std::set<std::string_view> players;
+    for (const auto& [player, groupUuids] : snapshot_->memberships()) players.insert(player);
+    for (const auto& [node, acl] : snapshot_->acls()) {
+        nodes_.push_back(node);
+        for (const auto& ace : acl) {
+            if (ace.subjectType == 0 && ace.subjectUuid != "*") players.insert(ace.subjectUuid);
+        }
+    }
+    for (const auto player : players) {
+        subjects_.push_back({.kind = SubjectKind::Player, .uuid = std::string(player), .name = {}});
+    }
+
+    // The deciding ACL of a node does not depend on the subject; look it up once.
+    std::ranges::sort(nodes_);
+    nearest_.reserve(nodes_.size());
+    for (const auto node : nodes_) nearest_.push_back(snapshot_->findNearestACL(node));
+}
+
+void PermissionAudit::formatSubject(
+    const Subject&                     subject,
+    const AuditFormat                  format,
+    const std::span<const std::string> nodeCells,
+    std::string&                       out
+) const {
+    const auto  token = snapshot_->buildToken(subject.kind, subject.uuid);
+    const auto* kind  = subject.kind == SubjectKind::Group ? "group" : "player";
+
+    std::string prefix;
+    if (format == AuditFormat::Csv) {
+        prefix = std::string(kind) + ',' + csvCell(subject.uuid) + ',' + csvCell(subject.name) + ',';
+    } else {
+        prefix = std::string(R"({"kind":")") + kind + R"(","subject":)" + jsonCell(subject.uuid) + R"(,"name":)"
+               + jsonCell(subject.name) + R"(,"node":)";
+    }
+
+    for (std::size_t i = 0; i < nodes_.size(); ++i) {
+        const auto allow = PermissionResolver::resolve(nearest_[i], token) == AccessMask::Allow;
+        out             += prefix;
+        out             += nodeCells[i];
+        if (format == AuditFormat::Csv) {
+            out += allow ? ",allow\n" : ",deny\n";
+        } else {
+            out += allow ? ",\"access\":\"allow\"}\n" : ",\"access\":\"deny\"}\n";
+        }
+    }
+}
+
+auto PermissionAudit::run(
+    std::ostream&         out,
+    const AuditFormat     format,
+    std::size_t           threads,
+    const std::stop_token stop
+) const -> AuditStats {
+    if (threads == 0) threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::vector<std::string> nodeCells;
+    nodeCells.reserve(nodes_.size());
+    for (const auto node : nodes_) nodeCells.push_back(format == AuditFormat::Csv ? csvCell(node) : jsonCell(node));
+    if (format == AuditFormat::Csv) out << "subject_kind,subject,subject_name,node,access\n";
+
+    // Finished subjects wait in a ring of `window` slots until the writer reaches them; a worker does
+    // not start a subject until its slot is free.
+    const auto                              window = threads * kWindowPerThread;
+    std::vector<std::optional<std::string>> slots(window);
+    std::mutex                              mutex;
+    std::condition_variable_any             cv;
+    std::size_t                             written = 0;
+    bool                                    aborted = false;
+    std::exception_ptr                      error;
+    std::atomic<std::size_t>                next{0};
+
+    const auto fail = [&](std::exception_ptr e) {
+        {
+            std::lock_guard lock(mutex);
+            if (!error) error = std::move(e);
+            aborted = true;
+        }
+        cv.notify_all();
+    };
+
+    {
+        utils::thread::ThreadPool pool(threads);
+        for (std::size_t worker = 0; worker < pool.size(); ++worker) {
+            pool.submit([&] {
+                try {
+                    while (true) {
+                        const auto index = next.fetch_add(1, std::memory_order_relaxed);
+                        if (index >= subjects_.size()) return;
+                        {
+                            std::unique_lock lock(mutex);
+                            if (!cv.wait(lock, stop, [&] { return aborted || index < written + window; })) return;
+                            if (aborted) return;
+                        }
+                        std::string rows;
+                        formatSubject(subjects_[index], format, nodeCells, rows);
+                        {
+                            std::lock_guard lock(mutex);
+                            slots[index % window] = std::move(rows);
+                        }
+                        cv.notify_all();
+                    }
+                } catch (...) {
+                    fail(std::current_exception());
+                }
+            });
+        }
+
+        try {
+            for (std::size_t index = 0; index < subjects_.size(); ++index) {
+                std::string rows;
+                {
+                    std::unique_lock lock(mutex);
+                    if (!cv.wait(lock, stop, [&] { return aborted || slots[index % window].has_value(); })) break;
+                    if (aborted) break;
+                    rows = std::move(*slots[index % window]);
+                    slots[index % window].reset();
+                }
+                out.write(rows.data(), static_cast<std::streamsize>(rows.size()));
+                if (!out) throw utils::exception::OperationFailedException("Failed to write audit output");
+                {
+                    std::lock_guard lock(mutex);
+                    ++written;
+                }
+                cv.notify_all();
+            }
+        } catch (...) {
+            fail(std::current_exception());
+        }
+        if (stop.stop_requested()) fail(nullptr);
+    } // joins the workers
+
+    if (error) std::rethrow_exception(error);
+    if (written < subjects_.size()) throw utils::exception::OperationFailedException("Audit cancelled");
+    return {.subjects = subjects_.size(), .nodes = nodes_.size(), .rows = subjects_.size() * nodes_.size()};
+}
+
+auto PermissionAudit::writeTo(
+    const std::filesystem::path& path,
+    const AuditFormat            format,
+    const std::size_t            threads,
+    const std::stop_token        stop
+) const -> AuditStats {
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    AuditStats stats;
+    try {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file) throw utils::exception::OperationFailedException("Failed to open " + tmpPath.string());
+        stats = run(file, format, threads, stop);
+        if (!file.flush()) throw utils::exception::OperationFailedException("Failed to write " + tmpPath.string());
+    } catch (...) {
+        std::error_code ignored; // a cancelled audit can leave a large partial file behind
+        std::filesystem::remove(tmpPath, ignored);
+        throw;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        throw utils::exception::OperationFailedException("Failed to replace " + path.string() + ": " + ec.message());
+    }
+    return stats;
+}
+
+} // namespace BakaPerms::core
@@ -0,0 +1,64 @@
+#pragma once
+#include "BakaPerms/Core/PermissionSnapshot.hpp"
+#include "BakaPerms/Core/Types.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BakaPerms::core {
+
+/// Effective permission of every known subject on every ACL-bearing node of one snapshot: all groups
+/// by name, then every player that is a group member or named by an ACE, by uuid. Nodes are sorted,
+/// and include wildcard patterns and the root "*" as they appear in the ACL table.
+///
+/// Subjects are resolved in parallel, one subject per work item: idle workers claim the next one from
+/// a shared counter, so a few expensive subjects do not hold up the rest. Rows are written in subject
+/// order, and at most a few subjects per worker are held in memory at once.
+class PermissionAudit {
+public:
+    explicit PermissionAudit(std::shared_ptr<const PermissionSnapshot> snapshot);
+
+    [[nodiscard]] auto subjectCount() const noexcept -> std::size_t { return subjects_.size(); }
+    [[nodiscard]] auto nodeCount() const noexcept -> std::size_t { return nodes_.size(); }
+
+    /// Stream the matrix to `out` on `threads` workers, 0 for one per hardware thread. Throws
+    /// OperationFailedException if `stop` is requested or `out` fails; rows written before stay.
+    auto run(std::ostream& out, AuditFormat format, std::size_t threads, std::stop_token stop = {}) const
+        -> AuditStats;
+
+    /// run() into `path`, atomically (temp file + rename); `path` is left untouched on failure.
+    auto writeTo(
+        const std::filesystem::path& path,
+        AuditFormat                  format,
+        std::size_t                  threads,
+        std::stop_token              stop = {}
+    ) const -> AuditStats;
+
+private:
+    struct Subject {
+        SubjectKind kind;
+        std::string uuid;
+        std::string name; // group name, empty for players
+    };
+
+    /// Append the rows of `subject`; `nodeCells` are the nodes already quoted for `format`.
+    void formatSubject(
+        const Subject&               subject,
+        AuditFormat                  format,
+        std::span<const std::string> nodeCells,
+        std::string&                 out
+    ) const;
+
+    std::shared_ptr<const PermissionSnapshot> snapshot_;
+    std::vector<Subject>                      subjects_;
+    std::vector<std::string_view>             nodes_;   // sorted, pointing into the snapshot's ACL map
+    std::vector<std::span<const ACE>>         nearest_; // by node: the ACL that decides it
+};
+
+} // namespace BakaPerms::core
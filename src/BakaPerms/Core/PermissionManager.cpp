@@ -1,15 +1,66 @@
 #include "BakaPerms/Core/PermissionManager.hpp"
 
+#include "BakaPerms/Core/NodePattern.hpp"
+#include "BakaPerms/Core/PermissionAudit.hpp"
 #include "BakaPerms/Core/PermissionResolver.hpp"
+#include "BakaPerms/Data/PermissionTransfer.hpp"
 #include "BakaPerms/Utils/Exception/Exceptions.hpp"
 #include "BakaPerms/Utils/I18n/I18n.hpp"
 
+#include <ll/api/thread/ServerThreadExecutor.h>
 #include <mc/platform/UUID.h>
 
+#include <algorithm>
+#include <format>
+
 namespace BakaPerms::core {
 
-PermissionManager::PermissionManager(std::unique_ptr<database::IDatabase> db) : db_(std::move(db)), repo_(*db_) {
+// True if `node` is `ancestor` or lies below it in the dot hierarchy.
+static bool isSameOrDescendant(const std::string_view node, const std::string_view ancestor) {
+    return node.starts_with(ancestor) && (node.size() == ancestor.size() || node[ancestor.size()] == '.');
+}
+
+// True if the comma-terminated group list `signature` (see tokenSignature) contains `groupUuid`.
+static bool signatureContains(std::string_view signature, const std::string_view groupUuid) {
+    for (std::size_t end; (end = signature.find(',')) != std::string_view::npos; signature.remove_prefix(end + 1)) {
+        if (signature.substr(0, end) == groupUuid) return true;
+    }
+    return false;
+}
+
+// Nodes with an ACL in `before` but none in `after`. Such a node's subtree now resolves against the
+// next ACL up, which can change the decision for any player, not just those the edit named.
+static auto droppedACLs(const PermissionSnapshot& before, const PermissionSnapshot& after) -> std::vector<std::string> {
+    std::vector<std::string> nodes;
+    for (const auto& [node, acl] : before.acls()) {
+        if (after.getNodeACL(node).empty()) nodes.push_back(node);
+    }
+    return nodes;
+}
+
+// Index of `str` in `strings`, appending it on first use.
+static auto intern(StringMap<std::uint32_t>& ids, std::vector<std::string>& strings, const std::string_view str)
+    -> std::uint32_t {
+    const auto [it, inserted] = ids.try_emplace(std::string(str), static_cast<std::uint32_t>(strings.size()));
+    if (inserted) strings.emplace_back(str);
+    return it->second;
+}
+
+PermissionManager::PermissionManager(std::unique_ptr<database::IDatabase> db, PermissionManagerOptions options)
+: options_(std::move(options)),
+  db_(std::move(db)),
+  repo_(*db_, mce::UUID::random().asString()),
+  asyncPool_(options_.asyncThreads) {
     repo_.initializeSchema();
+    // Read before the snapshot, so an entry committed in between is applied again rather than missed.
+    syncedChangeId_ = repo_.latestChangeId();
+    if (!options_.snapshotImagePath.empty()) {
+        if (auto image = SnapshotImage::open(options_.snapshotImagePath)) {
+            loadSnapshotAsync(std::move(image));
+            return;
+        }
+    }
+    publish(PermissionSnapshot::load(repo_));
 }
 
 void PermissionManager::invalidate() {
@@ -19,28 +70,242 @@ void PermissionManager::invalidate() {
 // Permission checking
 auto PermissionManager::checkPermission(const std::string_view playerUuid, const std::string_view node) -> AccessMask {
     uint64_t gen;
+    if (const auto cached = findCachedDecision(playerUuid, node, gen)) return *cached;
+
+    metrics_.cacheMisses.add();
+    const utils::metrics::ScopedTimer timer(metrics_.missLatency);
+    if (const auto image = bootImage_.load(std::memory_order_acquire)) {
+        metrics_.imageChecks.add();
+        return image->check(playerUuid, node);
+    }
+    if (runPendingWarmUp(playerUuid)) {
+        if (const auto cached = findCachedDecision(playerUuid, node, gen)) return *cached;
+    }
+
+    const auto entry  = getPlayerEntry(playerUuid);
+    const auto result = resolveWithToken(*snapshot(), *entry.token, node);
+
+    {
+        std::unique_lock lock(cacheMutex_);
+        recordDemandLocked(node);
+        // Only write to cache if no invalidation occurred during resolution.
+        // This prevents stale results from being written into a freshly cleared cache.
+        if (cacheGeneration_ == gen && entry.decisions) {
+            entry.decisions->insert_or_assign(std::string(node), result);
+        }
+    }
+
+    return result;
+}
+
+auto PermissionManager::checkPermissionAsync(const std::string_view playerUuid, const std::string_view node)
+    -> std::future<AccessMask> {
+    if (node.empty()) {
+        throw utils::exception::InvalidArgumentException("Permission node must not be empty");
+    }
+
+    auto promise = std::make_shared<std::promise<AccessMask>>();
+    auto future  = promise->get_future();
+
+    uint64_t gen;
+    if (const auto cached = findCachedDecision(playerUuid, node, gen)) {
+        promise->set_value(*cached);
+        return future;
+    }
+
+    asyncPool_.submit([this, promise, player = std::string(playerUuid), node = std::string(node)] {
+        try {
+            promise->set_value(checkPermission(player, node));
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return future;
+}
+
+static void deliverDecision(
+    std::function<void(AccessMask)> callback,
+    const AccessMask                result,
+    const AsyncDelivery             delivery
+) {
+    if (delivery == AsyncDelivery::ServerThread) {
+        ll::thread::ServerThreadExecutor::getDefault().execute([callback = std::move(callback), result] {
+            callback(result);
+        });
+    } else {
+        callback(result);
+    }
+}
+
+void PermissionManager::checkPermissionAsync(
+    const std::string_view          playerUuid,
+    const std::string_view          node,
+    std::function<void(AccessMask)> callback,
+    const AsyncDelivery             delivery
+) {
+    if (node.empty()) {
+        throw utils::exception::InvalidArgumentException("Permission node must not be empty");
+    }
+
+    uint64_t gen;
+    if (const auto cached = findCachedDecision(playerUuid, node, gen)) {
+        deliverDecision(std::move(callback), *cached, delivery);
+        return;
+    }
+
+    asyncPool_.submit([this,
+                       callback = std::move(callback),
+                       delivery,
+                       player = std::string(playerUuid),
+                       node   = std::string(node)]() mutable {
+        // A failed check still completes the caller's continuation; it fails closed.
+        auto result = AccessMask::Deny;
+        try {
+            result = checkPermission(player, node);
+        } catch (const std::exception& e) {
+            logger.error("{}", "bakaperms.exception.operation_failed"_tr(e.what()));
+        }
+        deliverDecision(std::move(callback), result, delivery);
+    });
+}
+
+auto PermissionManager::checkPermissions(
+    const std::string_view                  playerUuid,
+    const std::span<const std::string_view> nodes
+) -> std::vector<AccessMask> {
+    return checkPermissionsImpl(playerUuid, nodes, true);
+}
+
+auto PermissionManager::checkPermissionsImpl(
+    const std::string_view                  playerUuid,
+    const std::span<const std::string_view> nodes,
+    const bool                              recordDemand
+) -> std::vector<AccessMask> {
+    std::vector<AccessMask>  results(nodes.size(), AccessMask::Deny);
+    std::vector<std::size_t> misses;
+    uint64_t                 gen;
     {
         std::shared_lock lock(cacheMutex_);
-        gen = cacheGeneration_;
-        if (const auto playerIt = cache_.find(std::string(playerUuid)); playerIt != cache_.end()) {
-            if (const auto nodeIt = playerIt->second.find(std::string(node)); nodeIt != playerIt->second.end()) {
-                return nodeIt->second;
+        gen                 = cacheGeneration_;
+        const auto playerIt = players_.find(playerUuid);
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            if (playerIt != players_.end()) {
+                const auto& cached = *playerIt->second.decisions;
+                if (const auto nodeIt = cached.find(nodes[i]); nodeIt != cached.end()) {
+                    results[i] = nodeIt->second;
+                    continue;
+                }
             }
+            misses.push_back(i);
         }
     }
+    metrics_.cacheHits.add(nodes.size() - misses.size());
+    metrics_.cacheMisses.add(misses.size());
+    if (misses.empty()) return results;
 
-    const auto result = resolvePermission(playerUuid, node);
+    if (const auto image = bootImage_.load(std::memory_order_acquire)) {
+        metrics_.imageChecks.add(misses.size());
+        for (const auto i : misses) {
+            results[i] = image->check(playerUuid, nodes[i]);
+        }
+        return results;
+    }
+
+    if (recordDemand) runPendingWarmUp(playerUuid); // not from the warm-up itself
+
+    // One token and one snapshot for the whole batch.
+    const auto entry = getPlayerEntry(playerUuid);
+    const auto snap  = snapshot();
+    for (const auto i : misses) {
+        results[i] = resolveWithToken(*snap, *entry.token, nodes[i]);
+    }
 
     {
         std::unique_lock lock(cacheMutex_);
-        // Only write to cache if no invalidation occurred during resolution.
-        // This prevents stale results from being written into a freshly cleared cache.
+        if (recordDemand) {
+            for (const auto i : misses) recordDemandLocked(nodes[i]);
+        }
+        if (cacheGeneration_ == gen && entry.decisions) {
+            for (const auto i : misses) {
+                entry.decisions->insert_or_assign(std::string(nodes[i]), results[i]);
+            }
+        }
+    }
+
+    return results;
+}
+
+auto PermissionManager::filterPlayersWithPermission(
+    const std::string_view                  node,
+    const std::span<const std::string_view> playerUuids
+) -> std::vector<std::string> {
+    if (node.empty()) {
+        throw utils::exception::InvalidArgumentException("Permission node must not be empty");
+    }
+
+    std::vector<AccessMask>  decisions(playerUuids.size(), AccessMask::Deny);
+    std::vector<std::size_t> misses;
+    uint64_t                 gen;
+    {
+        std::shared_lock lock(cacheMutex_);
+        gen = cacheGeneration_;
+        for (std::size_t i = 0; i < playerUuids.size(); ++i) {
+            if (const auto playerIt = players_.find(playerUuids[i]); playerIt != players_.end()) {
+                const auto& cached = *playerIt->second.decisions;
+                if (const auto nodeIt = cached.find(node); nodeIt != cached.end()) {
+                    decisions[i] = nodeIt->second;
+                    continue;
+                }
+            }
+            misses.push_back(i);
+        }
+    }
+    metrics_.cacheHits.add(playerUuids.size() - misses.size());
+    metrics_.cacheMisses.add(misses.size());
+
+    if (const auto image = bootImage_.load(std::memory_order_acquire)) {
+        metrics_.imageChecks.add(misses.size());
+        for (const auto i : misses) {
+            decisions[i] = image->check(playerUuids[i], node);
+        }
+    } else if (!misses.empty()) {
+        // The node's nearest ACL is looked up once and evaluated once per decision map, so players
+        // sharing a group set cost a single resolution. `snap` keeps the ACL alive across publishes.
+        const auto                                          snap = snapshot();
+        const auto                                          acl  = snap->findNearestACL(node);
+        std::vector<std::shared_ptr<DecisionMap>>           targets;
+        std::unordered_map<const DecisionMap*, AccessMask> resolved;
+        targets.reserve(misses.size());
+        for (const auto i : misses) {
+            const auto entry = getPlayerEntry(playerUuids[i]);
+            if (const auto it = resolved.find(entry.decisions.get()); entry.decisions && it != resolved.end()) {
+                decisions[i] = it->second;
+                continue;
+            }
+            {
+                const utils::metrics::ScopedTimer timer(metrics_.resolveLatency);
+                decisions[i] = PermissionResolver::resolve(acl, *entry.token);
+            }
+            if (entry.decisions) {
+                resolved.emplace(entry.decisions.get(), decisions[i]);
+                targets.push_back(entry.decisions);
+            }
+        }
+
+        std::unique_lock lock(cacheMutex_);
+        for (std::size_t n = 0; n < targets.size(); ++n) recordDemandLocked(node);
         if (cacheGeneration_ == gen) {
-            cache_[std::string(playerUuid)][std::string(node)] = result;
+            for (const auto& target : targets) {
+                target->insert_or_assign(std::string(node), resolved.at(target.get()));
+            }
         }
     }
 
-    return result;
+    std::vector<std::string> allowed;
+    for (std::size_t i = 0; i < playerUuids.size(); ++i) {
+        if (decisions[i] == AccessMask::Allow) allowed.emplace_back(playerUuids[i]);
+    }
+    return allowed;
 }
 
 // Trace
@@ -49,14 +314,13 @@ auto PermissionManager::tracePermission(
     const std::string_view uuid,
     const std::string_view node
 ) const -> PermissionTrace {
-    const auto token    = buildToken(kind, uuid);
-    const auto nodePath = PermissionResolver::buildNodePath(node);
-    const auto aclMap   = repo_.getNodeACLBatch(nodePath);
-    auto       trace =
-        PermissionResolver::resolveWithTrace(node, token, [&aclMap](const std::string_view n) -> std::vector<ACE> {
-            if (const auto it = aclMap.find(std::string(n)); it != aclMap.end()) return it->second;
-            return {};
-        });
+    const auto snap  = snapshot();
+    auto       trace = PermissionResolver::resolveWithTrace(
+        node,
+        snap->buildToken(kind, uuid),
+        [&snap](const std::string_view n) { return snap->getNodeACL(n); },
+        snap->findPatternACL(node)
+    );
     trace.subjectKind = kind;
     trace.subjectUuid = uuid;
     return trace;
@@ -69,8 +333,12 @@ void PermissionManager::appendACE(
     const int              subjectType,
     const AccessMask       mask
 ) {
-    repo_.appendACE(node, subjectUuid, subjectType, mask);
-    invalidateAll();
+    {
+        std::lock_guard lock(writeMutex_);
+        repo_.appendACE(node, subjectUuid, subjectType, mask);
+        refreshNodeACL(node);
+    }
+    invalidateSubtree(node);
 }
 
 void PermissionManager::insertACE(
@@ -80,18 +348,30 @@ void PermissionManager::insertACE(
     const int              subjectType,
     const AccessMask       mask
 ) {
-    repo_.insertACE(node, position, subjectUuid, subjectType, mask);
-    invalidateAll();
+    {
+        std::lock_guard lock(writeMutex_);
+        repo_.insertACE(node, position, subjectUuid, subjectType, mask);
+        refreshNodeACL(node);
+    }
+    invalidateSubtree(node);
 }
 
 void PermissionManager::removeACE(const std::string_view node, const int position) {
-    repo_.removeACE(node, position);
-    invalidateAll();
+    {
+        std::lock_guard lock(writeMutex_);
+        repo_.removeACE(node, position);
+        refreshNodeACL(node);
+    }
+    invalidateSubtree(node);
 }
 
 void PermissionManager::moveACE(const std::string_view node, const int from, const int to) {
-    repo_.moveACE(node, from, to);
-    invalidateAll();
+    {
+        std::lock_guard lock(writeMutex_);
+        repo_.moveACE(node, from, to);
+        refreshNodeACL(node);
+    }
+    invalidateSubtree(node);
 }
 
 auto PermissionManager::getNodeACL(const std::string_view node) const -> std::vector<ACE> {
@@ -99,8 +379,12 @@ auto PermissionManager::getNodeACL(const std::string_view node) const -> std::ve
 }
 
 void PermissionManager::clearNodeACL(const std::string_view node) {
-    repo_.clearNodeACL(node);
-    invalidateAll();
+    {
+        std::lock_guard lock(writeMutex_);
+        repo_.clearNodeACL(node);
+        refreshNodeACL(node);
+    }
+    invalidateSubtree(node);
 }
 
 // Group management
@@ -108,28 +392,44 @@ auto PermissionManager::createGroup(
     const std::string_view                 name,
     const std::optional<std::string_view>& parentUuid
 ) const -> std::string {
+    std::lock_guard lock(writeMutex_);
     if (repo_.getGroupByName(name)) {
         throw utils::exception::OperationFailedException("bakaperms.exception.detail.group_exists"_tr(name));
     }
     auto uuid = mce::UUID::random().asString();
     repo_.createGroup(uuid, name, parentUuid);
+    refreshGroup(uuid);
     return uuid;
 }
 
 void PermissionManager::deleteGroup(const std::string_view groupUuid) {
-    repo_.deleteGroup(groupUuid);
-    invalidateAll();
+    std::vector<std::string> dropped;
+    {
+        std::lock_guard lock(writeMutex_);
+        repo_.deleteGroup(groupUuid);
+        // Cascades touch memberships, child groups and every ACL naming the group; reload them all.
+        const auto before = snapshot();
+        auto       after  = PermissionSnapshot::load(repo_, before->revision() + 1);
+        dropped           = droppedACLs(*before, *after);
+        publish(std::move(after));
+    }
+    invalidateGroupMembers(groupUuid);
+    for (const auto& node : dropped) invalidateSubtree(node);
 }
 
 void PermissionManager::setGroupParent(
     const std::string_view                 groupUuid,
     const std::optional<std::string_view>& parentUuid
 ) {
-    if (parentUuid && wouldCreateCycle(groupUuid, *parentUuid)) {
-        throw utils::exception::OperationFailedException("bakaperms.exception.detail.group_cycle"_tr());
+    {
+        std::lock_guard lock(writeMutex_);
+        if (parentUuid && wouldCreateCycle(groupUuid, *parentUuid)) {
+            throw utils::exception::OperationFailedException("bakaperms.exception.detail.group_cycle"_tr());
+        }
+        repo_.setGroupParent(groupUuid, parentUuid);
+        refreshGroup(groupUuid);
     }
-    repo_.setGroupParent(groupUuid, parentUuid);
-    invalidateAll();
+    invalidateGroupMembers(groupUuid);
 }
 
 auto PermissionManager::getGroup(const std::string_view uuid) const -> std::optional<GroupInfo> {
@@ -144,13 +444,21 @@ auto PermissionManager::getAllGroups() const -> std::vector<GroupInfo> { return
 
 // Membership
 bool PermissionManager::addPlayerToGroup(const std::string_view playerUuid, const std::string_view groupUuid) {
-    if (!repo_.addPlayerToGroup(playerUuid, groupUuid)) return false;
+    {
+        std::lock_guard lock(writeMutex_);
+        if (!repo_.addPlayerToGroup(playerUuid, groupUuid)) return false;
+        refreshMemberships(playerUuid);
+    }
     invalidatePlayer(playerUuid);
     return true;
 }
 
 bool PermissionManager::removePlayerFromGroup(const std::string_view playerUuid, const std::string_view groupUuid) {
-    if (!repo_.removePlayerFromGroup(playerUuid, groupUuid)) return false;
+    {
+        std::lock_guard lock(writeMutex_);
+        if (!repo_.removePlayerFromGroup(playerUuid, groupUuid)) return false;
+        refreshMemberships(playerUuid);
+    }
     invalidatePlayer(playerUuid);
     return true;
 }
@@ -167,63 +475,653 @@ auto PermissionManager::getSubjectACEs(const std::string_view subjectUuid) const
     return repo_.getSubjectACEs(subjectUuid);
 }
 
+// Bulk transfer
+auto PermissionManager::exportData(const std::filesystem::path& path, const TransferFormat format) const
+    -> TransferStats {
+    std::lock_guard lock(writeMutex_); // a consistent view across the paged scans
+    return data::PermissionTransfer(*db_, repo_).exportTo(path, format);
+}
+
+auto PermissionManager::importData(const std::filesystem::path& path, const TransferFormat format) -> TransferStats {
+    TransferStats      stats;
+    std::exception_ptr error;
+    {
+        std::lock_guard lock(writeMutex_);
+        try {
+            stats = data::PermissionTransfer(*db_, repo_).importFrom(path, format);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        // One reload for the whole import; also publishes the batches committed before a failure.
+        publish(PermissionSnapshot::load(repo_, snapshot()->revision() + 1));
+    }
+    invalidateAll();
+    if (error) std::rethrow_exception(error);
+    return stats;
+}
+
+// Audit
+bool PermissionManager::startAudit(const std::filesystem::path& path, const AuditFormat format) {
+    auto snap = snapshot(); // before claiming the flag: throws if the startup load failed
+    if (auditRunning_.exchange(true)) return false;
+    try {
+        if (auditJob_.joinable()) auditJob_.join(); // the previous audit, already past its last log line
+        auditJob_ = std::jthread([this, snap = std::move(snap), path, format](const std::stop_token stop) {
+            try {
+                const auto stats = PermissionAudit(snap).writeTo(path, format, options_.auditThreads, stop);
+                logger.info(
+                    "{}",
+                    "bakaperms.audit.finished"_tr(stats.rows, stats.subjects, stats.nodes, path.string())
+                );
+            } catch (const std::exception& e) {
+                logger.error("{}", "bakaperms.audit.failed"_tr(e.what()));
+            }
+            auditRunning_ = false;
+        });
+    } catch (...) {
+        auditRunning_ = false;
+        throw;
+    }
+    return true;
+}
+
+void PermissionManager::cancelAudit() {
+    if (!auditJob_.joinable()) return;
+    auditJob_.request_stop();
+    auditJob_.join();
+}
+
+bool PermissionManager::startImport(const std::filesystem::path& path, const TransferFormat format) {
+    if (importRunning_.exchange(true)) return false;
+    try {
+        if (importJob_.joinable()) importJob_.join(); // the previous import, already past its last log line
+        importJob_ = std::jthread([this, path, format] {
+            try {
+                const auto stats = importData(path, format);
+                logger.info(
+                    "{}",
+                    "bakaperms.transfer.imported"_tr(stats.groups, stats.memberships, stats.aces, path.string())
+                );
+            } catch (const std::exception& e) {
+                logger.error("{}", "bakaperms.transfer.import_failed"_tr(e.what()));
+            }
+            importRunning_ = false;
+        });
+    } catch (...) {
+        importRunning_ = false;
+        throw;
+    }
+    return true;
+}
+
 // Cache
 void PermissionManager::invalidatePlayer(const std::string_view uuid) {
+    metrics_.playerInvalidations.add();
     std::unique_lock lock(cacheMutex_);
     ++cacheGeneration_;
-    cache_.erase(std::string(uuid));
+    evictPlayerLocked(uuid);
 }
 
 void PermissionManager::invalidateAll() {
+    metrics_.fullInvalidations.add();
     std::unique_lock lock(cacheMutex_);
     ++cacheGeneration_;
-    cache_.clear();
+    players_.clear();
+    sharedDecisions_.clear();
+    groupPlayers_.clear();
 }
 
-auto PermissionManager::buildToken(const SubjectKind kind, const std::string_view uuid) const -> AccessToken {
-    AccessToken token;
+void PermissionManager::warmUpPlayer(const std::string_view uuid) {
+    {
+        std::unique_lock lock(cacheMutex_);
+        pendingWarmUps_.insert_or_assign(std::string(uuid), PendingWarmUp{.ticket = ++warmUpTickets_});
+        pendingWarmUpCount_.store(pendingWarmUps_.size(), std::memory_order_relaxed);
+    }
+    asyncPool_.submit([this, uuid = std::string(uuid)] {
+        if (const auto ticket = claimWarmUp(uuid)) runWarmUp(uuid, *ticket);
+    });
+}
 
-    if (kind == SubjectKind::Player) {
-        token.add(std::string(uuid), TokenEntryKind::Subject);
-        const auto groups = repo_.getPlayerGroups(uuid);
-        // First pass: add all direct groups so they are never mislabeled as InheritedGroup
-        for (const auto& group : groups) {
-            token.add(group.uuid, TokenEntryKind::DirectGroup);
+void PermissionManager::cancelWarmUp(const std::string_view uuid) {
+    std::unique_lock lock(cacheMutex_);
+    if (const auto it = pendingWarmUps_.find(uuid); it != pendingWarmUps_.end()) {
+        pendingWarmUps_.erase(it);
+        pendingWarmUpCount_.store(pendingWarmUps_.size(), std::memory_order_relaxed);
+    }
+}
+
+auto PermissionManager::claimWarmUp(const std::string_view uuid) -> std::optional<std::uint64_t> {
+    std::unique_lock lock(cacheMutex_);
+    const auto       it = pendingWarmUps_.find(uuid);
+    if (it == pendingWarmUps_.end() || it->second.claimed) return std::nullopt;
+    it->second.claimed = true;
+    return it->second.ticket;
+}
+
+void PermissionManager::runWarmUp(const std::string_view uuid, const std::uint64_t ticket) {
+    try {
+        const auto                    nodes = getWarmUpNodes();
+        std::vector<std::string_view> views(nodes.begin(), nodes.end());
+        checkPermissionsImpl(uuid, views, false); // also builds and caches the token
+    } catch (const std::exception& e) {
+        logger.error("{}", "bakaperms.exception.operation_failed"_tr(e.what()));
+    }
+
+    std::unique_lock lock(cacheMutex_);
+    if (const auto it = pendingWarmUps_.find(uuid); it == pendingWarmUps_.end()) {
+        // Cancelled while running: the player has left, so drop the entry this may have cached.
+        evictPlayerLocked(uuid);
+    } else if (it->second.ticket == ticket) {
+        pendingWarmUps_.erase(it);
+    } // else the player joined again; that warm-up is still to run
+    pendingWarmUpCount_.store(pendingWarmUps_.size(), std::memory_order_relaxed);
+}
+
+bool PermissionManager::runPendingWarmUp(const std::string_view uuid) {
+    if (pendingWarmUpCount_.load(std::memory_order_relaxed) == 0) return false;
+    const auto ticket = claimWarmUp(uuid);
+    if (!ticket) return false;
+    runWarmUp(uuid, *ticket);
+    return true;
+}
+
+auto PermissionManager::getWarmUpNodes() const -> std::vector<std::string> {
+    std::vector<std::string> nodes = options_.warmUpNodes;
+
+    std::vector<std::pair<std::string_view, std::uint32_t>> ranked;
+    std::shared_lock                                        lock(cacheMutex_);
+    ranked.assign(nodeDemand_.begin(), nodeDemand_.end());
+    const auto top = std::min(ranked.size(), options_.learnedWarmUpNodes);
+    std::ranges::partial_sort(
+        ranked,
+        ranked.begin() + static_cast<std::ptrdiff_t>(top),
+        std::ranges::greater{},
+        &std::pair<std::string_view, std::uint32_t>::second
+    );
+    for (std::size_t i = 0; i < top; ++i) {
+        if (std::ranges::find(options_.warmUpNodes, ranked[i].first) == options_.warmUpNodes.end()) {
+            nodes.emplace_back(ranked[i].first);
+        }
+    }
+    return nodes;
+}
+
+auto PermissionManager::exportHotDecisions(const std::size_t maxEntries) const -> HotDecisions {
+    struct Candidate {
+        std::string_view signature;
+        std::string_view node;
+        AccessMask       mask;
+        std::uint32_t    demand;
+    };
+
+    HotDecisions hot;
+    hot.fingerprint = snapshot()->fingerprint();
+
+    StringMap<std::uint32_t> signatureIds;
+    StringMap<std::uint32_t> nodeIds;
+    std::vector<Candidate>   candidates;
+
+    std::shared_lock lock(cacheMutex_);
+    // Personal decisions are not exported: restoring them would need the player's token up front.
+    for (const auto& [signature, decisions] : sharedDecisions_) {
+        for (const auto& [node, mask] : *decisions) {
+            const auto it = nodeDemand_.find(node);
+            candidates.push_back({signature, node, mask, it != nodeDemand_.end() ? it->second : 0});
+        }
+    }
+    const auto keep = std::min(candidates.size(), maxEntries);
+    std::ranges::partial_sort(
+        candidates,
+        candidates.begin() + static_cast<std::ptrdiff_t>(keep),
+        std::ranges::greater{},
+        &Candidate::demand
+    );
+
+    hot.entries.reserve(keep);
+    for (std::size_t i = 0; i < keep; ++i) {
+        const auto& c = candidates[i];
+        hot.entries.push_back(
+            {intern(signatureIds, hot.signatures, c.signature), intern(nodeIds, hot.nodes, c.node), c.mask}
+        );
+    }
+    for (const auto& [node, count] : nodeDemand_) {
+        hot.demand.push_back({intern(nodeIds, hot.nodes, node), count});
+    }
+    return hot;
+}
+
+auto PermissionManager::importHotDecisions(const HotDecisions& hot) -> std::size_t {
+    {
+        std::unique_lock lock(cacheMutex_);
+        for (const auto& [node, count] : hot.demand) {
+            if (nodeDemand_.size() >= kMaxTrackedNodes) break;
+            nodeDemand_.try_emplace(hot.nodes[node], count);
+        }
+    }
+
+    uint64_t gen;
+    {
+        std::shared_lock lock(cacheMutex_);
+        gen = cacheGeneration_;
+    }
+    // Decisions are only as good as the data they were resolved against. During startup that is the
+    // boot image; the load invalidates everything if the database turns out to differ from it.
+    const auto image       = bootImage_.load(std::memory_order_acquire);
+    const auto fingerprint = image ? image->fingerprint() : snapshot()->fingerprint();
+    if (hot.entries.empty() || hot.fingerprint != fingerprint) return 0;
+
+    std::unique_lock lock(cacheMutex_);
+    if (cacheGeneration_ != gen) return 0;
+    for (const auto& entry : hot.entries) {
+        auto& decisions = sharedDecisions_[hot.signatures[entry.signature]];
+        if (!decisions) decisions = std::make_shared<DecisionMap>();
+        decisions->try_emplace(hot.nodes[entry.node], entry.mask);
+    }
+    return hot.entries.size();
+}
+
+// Counts cold (player, node) resolutions, i.e. how many players needed a node. Counts are halved
+// periodically so the learned warm-up set follows what is being checked now.
+void PermissionManager::recordDemandLocked(const std::string_view node) {
+    if (options_.learnedWarmUpNodes == 0 || node.empty()) return;
+
+    if (const auto it = nodeDemand_.find(node); it != nodeDemand_.end()) {
+        ++it->second;
+    } else if (nodeDemand_.size() < kMaxTrackedNodes) {
+        nodeDemand_.emplace(node, 1);
+    }
+
+    if (++demandSamples_ < kDemandDecayInterval) return;
+    demandSamples_ = 0;
+    for (auto it = nodeDemand_.begin(); it != nodeDemand_.end();) {
+        it = (it->second /= 2) == 0 ? nodeDemand_.erase(it) : std::next(it);
+    }
+}
+
+// ACL edits change decisions but never tokens.
+void PermissionManager::invalidateSubtree(const std::string_view node) {
+    metrics_.subtreeInvalidations.add();
+    // Every node a pattern applies to lies below its literal prefix.
+    const auto scope = NodePatternMatcher::literalPrefix(node);
+    const auto evict = [scope](DecisionMap& decisions) {
+        if (scope.empty() || scope == "*") {
+            decisions.clear();
+        } else {
+            std::erase_if(decisions, [scope](const auto& entry) { return isSameOrDescendant(entry.first, scope); });
         }
-        // Second pass: add ancestor groups (skip index 0 which is the direct group itself)
-        for (const auto& group : groups) {
-            auto ancestry = repo_.getGroupAncestry(group.uuid);
-            for (std::size_t i = 1; i < ancestry.size(); ++i) {
-                token.add(ancestry[i].uuid, TokenEntryKind::InheritedGroup);
+    };
+
+    const auto       snap = snapshot();
+    std::unique_lock lock(cacheMutex_);
+    ++cacheGeneration_;
+    for (auto it = sharedDecisions_.begin(); it != sharedDecisions_.end();) {
+        evict(*it->second);
+        // Drop maps that are empty and no longer linked from any player.
+        it = it->second->empty() && it->second.use_count() == 1 ? sharedDecisions_.erase(it) : std::next(it);
+    }
+
+    // The edit may have added the first or removed the last ACE naming a player, moving them
+    // between the shared and the personal layer; re-link those on their next check.
+    std::vector<std::string> moved;
+    for (const auto& [player, entry] : players_) {
+        if (entry.personal) evict(*entry.decisions);
+        if (entry.personal != snap->isACESubject(player)) moved.push_back(player);
+    }
+    for (const auto& player : moved) {
+        evictPlayerLocked(player);
+    }
+}
+
+void PermissionManager::reload() {
+    {
+        std::lock_guard lock(writeMutex_);
+        publish(PermissionSnapshot::load(repo_, snapshot()->revision() + 1));
+    }
+    invalidateAll();
+}
+
+// Change log
+void PermissionManager::syncRemoteChanges() {
+    using data::ChangeKind;
+
+    std::vector<data::ChangeEntry> changes;
+    std::vector<std::string>       dropped;
+    bool                           reloaded = false;
+    {
+        std::lock_guard lock(writeMutex_);
+        auto feed = repo_.getChangesSince(syncedChangeId_, static_cast<int>(kMaxTargetedChanges) + 1);
+        if (feed.latestId <= syncedChangeId_) return;
+
+        const bool missed = feed.oldestId > syncedChangeId_ + 1;
+        const bool reload = std::ranges::any_of(feed.entries, [](const data::ChangeEntry& change) {
+            return change.kind == ChangeKind::Reload;
+        });
+        if (missed || reload || feed.entries.size() > kMaxTargetedChanges) {
+            publish(PermissionSnapshot::load(repo_, snapshot()->revision() + 1));
+            reloaded = true;
+        } else if (std::ranges::any_of(feed.entries, [](const data::ChangeEntry& change) {
+                       return change.kind == ChangeKind::GroupDeleted;
+                   })) {
+            // Its cascades are not logged; reload the snapshot once, as deleteGroup() does.
+            const auto before = snapshot();
+            auto       after  = PermissionSnapshot::load(repo_, before->revision() + 1);
+            dropped           = droppedACLs(*before, *after);
+            publish(std::move(after));
+        } else {
+            // Refreshes read the current rows, so a target named by several entries is read once.
+            std::unordered_set<std::string> seen;
+            for (const auto& change : feed.entries) {
+                if (!seen.insert(std::format("{}:{}", static_cast<int>(change.kind), change.target)).second) continue;
+                if (change.kind == ChangeKind::Group) refreshGroup(change.target);
+                if (change.kind == ChangeKind::Membership) refreshMemberships(change.target);
+                if (change.kind == ChangeKind::Node) refreshNodeACL(change.target);
             }
         }
-    } else {
-        // Group: the group itself + its ancestry
-        const auto ancestry = repo_.getGroupAncestry(uuid);
-        for (std::size_t i = 0; i < ancestry.size(); ++i) {
-            token.add(ancestry[i].uuid, i == 0 ? TokenEntryKind::Subject : TokenEntryKind::InheritedGroup);
+        syncedChangeId_ = feed.latestId;
+        changes         = std::move(feed.entries);
+    }
+
+    if (reloaded) {
+        metrics_.syncReloads.add();
+        invalidateAll();
+        return;
+    }
+    metrics_.remoteChanges.add(changes.size());
+    for (const auto& change : changes) {
+        switch (change.kind) {
+        case ChangeKind::Group:
+        case ChangeKind::GroupDeleted:
+            invalidateGroupMembers(change.target);
+            break;
+        case ChangeKind::Membership:
+            invalidatePlayer(change.target);
+            break;
+        case ChangeKind::Node:
+            invalidateSubtree(change.target);
+            break;
+        case ChangeKind::Reload: // handled above
+            break;
         }
     }
+    for (const auto& node : dropped) invalidateSubtree(node);
+}
+
+auto PermissionManager::trimChangeLog(const std::chrono::seconds retention) const -> int {
+    return repo_.trimChangeLog(std::chrono::system_clock::now() - retention);
+}
+
+// Metrics
+void PermissionManager::collectMetrics(utils::metrics::MetricVisitor& visitor) const {
+    visitor.counter(
+        "bakaperms_cache_hits_total",
+        "Checks answered from the decision cache.",
+        {},
+        metrics_.cacheHits.value()
+    );
+    visitor.counter(
+        "bakaperms_cache_misses_total",
+        "Checks that missed the decision cache.",
+        {},
+        metrics_.cacheMisses.value()
+    );
+    visitor.counter(
+        "bakaperms_image_checks_total",
+        "Cache misses answered from the snapshot image during startup.",
+        {},
+        metrics_.imageChecks.value()
+    );
+    visitor.histogram(
+        "bakaperms_check_miss_seconds",
+        "Latency of checkPermission calls that missed the decision cache.",
+        {},
+        metrics_.missLatency.snapshot()
+    );
+    visitor.histogram(
+        "bakaperms_resolve_seconds",
+        "Time to evaluate a node's nearest ACL against an access token.",
+        {},
+        metrics_.resolveLatency.snapshot()
+    );
+
+    const auto invalidations = [&visitor](const std::string_view scope, const utils::metrics::Counter& counter) {
+        visitor.counter("bakaperms_invalidations_total", "Decision cache invalidations.", scope, counter.value());
+    };
+    invalidations(R"(scope="player")", metrics_.playerInvalidations);
+    invalidations(R"(scope="group")", metrics_.groupInvalidations);
+    invalidations(R"(scope="subtree")", metrics_.subtreeInvalidations);
+    invalidations(R"(scope="all")", metrics_.fullInvalidations);
+
+    visitor.counter(
+        "bakaperms_sync_changes_total",
+        "Change log entries written by other servers and applied here.",
+        {},
+        metrics_.remoteChanges.value()
+    );
+    visitor.counter(
+        "bakaperms_sync_reloads_total",
+        "Full reloads done because change log entries were trimmed unseen or arrived in bulk.",
+        {},
+        metrics_.syncReloads.value()
+    );
+
+    std::size_t players;
+    std::size_t groupSets;
+    {
+        std::shared_lock lock(cacheMutex_);
+        players   = players_.size();
+        groupSets = sharedDecisions_.size();
+    }
+    visitor.gauge("bakaperms_cached_players", "Players with a cached access token.", {}, static_cast<double>(players));
+    visitor.gauge(
+        "bakaperms_shared_decision_maps",
+        "Decision maps shared by players with the same group set.",
+        {},
+        static_cast<double>(groupSets)
+    );
+
+    db_->collectMetrics(visitor);
+}
+
+auto PermissionManager::getStatementProfiles() const -> std::vector<database::StatementProfile> {
+    return db_->getStatementProfiles();
+}
 
-    return token;
+// Snapshot
+auto PermissionManager::snapshot() const -> std::shared_ptr<const PermissionSnapshot> {
+    if (auto snap = snapshot_.load(std::memory_order_acquire)) return snap;
+    snapshotLoaded_.get(); // rethrows if the startup load failed
+    return snapshot_.load(std::memory_order_acquire);
 }
 
-auto PermissionManager::resolvePermission(const std::string_view playerUuid, const std::string_view node) const
-    -> AccessMask {
-    const auto token    = buildToken(SubjectKind::Player, playerUuid);
-    const auto nodePath = PermissionResolver::buildNodePath(node);
-    const auto aclMap   = repo_.getNodeACLBatch(nodePath);
+void PermissionManager::publish(std::shared_ptr<const PermissionSnapshot> next) const {
+    snapshot_.store(std::move(next), std::memory_order_release);
+    scheduleImageWrite();
+}
+
+void PermissionManager::loadSnapshotAsync(std::shared_ptr<const SnapshotImage> image) {
+    auto       loaded      = std::make_shared<std::promise<void>>();
+    const auto fingerprint = image->fingerprint();
+    snapshotLoaded_        = loaded->get_future().share();
+    bootImage_.store(std::move(image), std::memory_order_release);
+
+    // No writeMutex_ here: a writer holding it blocks in snapshot() until this load is published,
+    // then re-reads the rows it committed, so a write racing the load is not lost.
+    asyncPool_.submit([this, loaded, fingerprint] {
+        try {
+            auto       snap  = PermissionSnapshot::load(repo_);
+            const bool stale = snap->fingerprint() != fingerprint;
+            snapshot_.store(std::move(snap), std::memory_order_release);
+            bootImage_.store(nullptr, std::memory_order_release);
+            loaded->set_value();
+            if (stale) {
+                logger.warn("{}", "bakaperms.snapshot.stale_image"_tr());
+                invalidateAll(); // drops hot decisions restored against the image
+                scheduleImageWrite();
+            }
+        } catch (const std::exception& e) {
+            // Keep answering checks from the image; everything else reports the error.
+            logger.error("{}", "bakaperms.exception.operation_failed"_tr(e.what()));
+            loaded->set_exception(std::current_exception());
+        }
+    });
+}
 
-    return PermissionResolver::resolve(node, token, [&aclMap](const std::string_view n) -> std::vector<ACE> {
-        if (const auto it = aclMap.find(std::string(n)); it != aclMap.end()) return it->second;
-        return {};
+void PermissionManager::scheduleImageWrite() const {
+    // Coalesced: a burst of commits queues a single write, which picks up the latest snapshot.
+    if (options_.snapshotImagePath.empty() || imageWritePending_.exchange(true)) return;
+    asyncPool_.submit([this] {
+        std::lock_guard lock(imageWriteMutex_);
+        imageWritePending_.store(false);
+        try {
+            SnapshotImage::write(options_.snapshotImagePath, *snapshot());
+        } catch (const std::exception& e) {
+            logger.warn("{}", "bakaperms.snapshot.save_failed"_tr(e.what()));
+        }
     });
 }
 
+void PermissionManager::refreshGroup(const std::string_view groupUuid) const {
+    const auto snap   = snapshot();
+    auto       groups = snap->groups();
+    if (auto group = repo_.getGroup(groupUuid)) {
+        groups.set(std::string(groupUuid), std::move(*group));
+    } else {
+        groups.erase(groupUuid);
+    }
+    publish(snap->withGroups(std::move(groups)));
+}
+
+void PermissionManager::refreshMemberships(const std::string_view playerUuid) const {
+    const auto               snap        = snapshot();
+    auto                     memberships = snap->memberships();
+    std::vector<std::string> groupUuids;
+    for (auto& group : repo_.getPlayerGroups(playerUuid)) {
+        groupUuids.push_back(std::move(group.uuid));
+    }
+    if (!groupUuids.empty()) {
+        memberships.set(std::string(playerUuid), std::move(groupUuids));
+    } else {
+        memberships.erase(playerUuid);
+    }
+    publish(snap->withMemberships(std::move(memberships)));
+}
+
+void PermissionManager::refreshNodeACL(const std::string_view node) const {
+    publish(snapshot()->withNodeACL(std::string(node), repo_.getNodeACL(node)));
+}
+
+void PermissionManager::invalidateGroupMembers(const std::string_view groupUuid) {
+    metrics_.groupInvalidations.add();
+    std::unique_lock lock(cacheMutex_);
+    ++cacheGeneration_;
+    if (const auto it = groupPlayers_.find(groupUuid); it != groupPlayers_.end()) {
+        // Copy: evicting a player also removes it from this set.
+        for (const auto players = it->second; const auto& player : players) {
+            evictPlayerLocked(player);
+        }
+    }
+    // Group sets containing a deleted group lose its ACEs, so their shared decisions go too.
+    std::erase_if(sharedDecisions_, [groupUuid](const auto& entry) {
+        return signatureContains(entry.first, groupUuid);
+    });
+}
+
+void PermissionManager::evictPlayerLocked(const std::string_view uuid) {
+    const auto it = players_.find(uuid);
+    if (it == players_.end()) return;
+    for (const auto& [groupUuid, kind] : it->second.token->entries()) {
+        if (kind == TokenEntryKind::Subject) continue;
+        if (const auto groupIt = groupPlayers_.find(groupUuid); groupIt != groupPlayers_.end()) {
+            groupIt->second.erase(std::string(uuid));
+            if (groupIt->second.empty()) groupPlayers_.erase(groupIt);
+        }
+    }
+    players_.erase(it);
+}
+
+auto PermissionManager::getPlayerEntry(const std::string_view playerUuid) const -> PlayerEntry {
+    uint64_t gen;
+    {
+        std::shared_lock lock(cacheMutex_);
+        if (const auto it = players_.find(playerUuid); it != players_.end()) return it->second;
+        gen = cacheGeneration_;
+    }
+
+    const auto  snap = snapshot();
+    PlayerEntry entry{
+        .token     = std::make_shared<const AccessToken>(snap->buildToken(SubjectKind::Player, playerUuid)),
+        .decisions = nullptr,
+        .personal  = snap->isACESubject(playerUuid),
+    };
+
+    std::unique_lock lock(cacheMutex_);
+    // Same generation guard as the decision cache: never cache a token built before an invalidation.
+    // The returned entry then has no decision map and callers skip the write-back.
+    if (cacheGeneration_ != gen) return entry;
+    if (const auto it = players_.find(playerUuid); it != players_.end()) return it->second;
+
+    if (entry.personal) {
+        entry.decisions = std::make_shared<DecisionMap>();
+    } else {
+        auto& shared = sharedDecisions_[tokenSignature(*entry.token)];
+        if (!shared) shared = std::make_shared<DecisionMap>();
+        entry.decisions = shared;
+    }
+    for (const auto& [groupUuid, kind] : entry.token->entries()) {
+        if (kind != TokenEntryKind::Subject) groupPlayers_[groupUuid].emplace(playerUuid);
+    }
+    players_.emplace(std::string(playerUuid), entry);
+    return entry;
+}
+
+auto PermissionManager::tokenSignature(const AccessToken& token) -> std::string {
+    std::vector<std::string_view> groups;
+    for (const auto& [uuid, kind] : token.entries()) {
+        if (kind != TokenEntryKind::Subject) groups.emplace_back(uuid);
+    }
+    std::ranges::sort(groups);
+
+    std::string signature;
+    for (const auto group : groups) {
+        signature += group;
+        signature += ',';
+    }
+    return signature;
+}
+
+auto PermissionManager::findCachedDecision(
+    const std::string_view playerUuid,
+    const std::string_view node,
+    uint64_t&              gen
+) const -> std::optional<AccessMask> {
+    std::shared_lock lock(cacheMutex_);
+    gen = cacheGeneration_;
+    if (const auto playerIt = players_.find(playerUuid); playerIt != players_.end()) {
+        const auto& decisions = *playerIt->second.decisions;
+        if (const auto nodeIt = decisions.find(node); nodeIt != decisions.end()) {
+            metrics_.cacheHits.add();
+            return nodeIt->second;
+        }
+    }
+    return std::nullopt;
+}
+
+auto PermissionManager::resolveWithToken(
+    const PermissionSnapshot& snap,
+    const AccessToken&        token,
+    const std::string_view    node
+) const -> AccessMask {
+    if (node.empty()) {
+        throw utils::exception::InvalidArgumentException("Permission node must not be empty");
+    }
+    const utils::metrics::ScopedTimer timer(metrics_.resolveLatency);
+    return PermissionResolver::resolve(snap.findNearestACL(node), token);
+}
+
 // Private helpers
 bool PermissionManager::wouldCreateCycle(const std::string_view groupUuid, const std::string_view parentUuid) const {
-    const auto ancestry = repo_.getGroupAncestry(parentUuid);
-    return std::ranges::any_of(ancestry, [&](const auto& ancestor) { return ancestor.uuid == groupUuid; });
+    const auto ancestry = snapshot()->getGroupAncestry(parentUuid);
+    return std::ranges::any_of(ancestry, [&](const auto* ancestor) { return ancestor->uuid == groupUuid; });
 }
 
 } // namespace BakaPerms::core
@@ -1,27 +1,58 @@
 #pragma once
+#include "BakaPerms/Core/HotDecisionFile.hpp"
 #include "BakaPerms/Core/IPermissionManager.hpp"
+#include "BakaPerms/Core/PermissionSnapshot.hpp"
+#include "BakaPerms/Core/SnapshotImage.hpp"
 #include "BakaPerms/Core/Types.hpp"
 #include "BakaPerms/Data/PermissionRepository.hpp"
 #include "BakaPerms/Database/IDatabase.hpp"
+#include "BakaPerms/Utils/Metrics/Metrics.hpp"
+#include "BakaPerms/Utils/Thread/ThreadPool.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <shared_mutex>
 #include <string>
 #include <string_view>
-#include <unordered_map>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
 namespace BakaPerms::core {
 
+struct PermissionManagerOptions {
+    std::size_t              asyncThreads{2};        // workers for checkPermissionAsync misses and warm-ups
+    std::vector<std::string> warmUpNodes;            // always pre-resolved by warmUpPlayer
+    std::size_t              learnedWarmUpNodes{32}; // most-missed nodes added to the warm-up set, 0 to disable
+    std::filesystem::path    snapshotImagePath;      // SnapshotImage mapped at startup and rewritten on commit
+    std::size_t              auditThreads{0};        // PermissionAudit workers, 0 for one per hardware thread
+};
+
 class PermissionManager final : public IPermissionManager {
 public:
-    explicit PermissionManager(std::unique_ptr<database::IDatabase> db);
+    explicit PermissionManager(std::unique_ptr<database::IDatabase> db, PermissionManagerOptions options = {});
 
     // ll::service lifecycle
     void invalidate() override;
 
     // Permission checking
     auto checkPermission(std::string_view playerUuid, std::string_view node) -> AccessMask override;
+    auto checkPermissions(std::string_view playerUuid, std::span<const std::string_view> nodes)
+        -> std::vector<AccessMask> override;
+    auto filterPlayersWithPermission(std::string_view node, std::span<const std::string_view> playerUuids)
+        -> std::vector<std::string> override;
+    auto checkPermissionAsync(std::string_view playerUuid, std::string_view node) -> std::future<AccessMask> override;
+    void checkPermissionAsync(
+        std::string_view                playerUuid,
+        std::string_view                node,
+        std::function<void(AccessMask)> callback,
+        AsyncDelivery                   delivery
+    ) override;
 
     // Trace
     auto tracePermission(SubjectKind kind, std::string_view uuid, std::string_view node) const
@@ -59,21 +90,172 @@ class PermissionManager final : public IPermissionManager {
     // Internal: query ACEs by subject (for display)
     auto getSubjectACEs(std::string_view subjectUuid) const -> std::vector<NodeACE> override;
 
+    // Bulk transfer
+    auto exportData(const std::filesystem::path& path, TransferFormat format) const -> TransferStats override;
+    auto importData(const std::filesystem::path& path, TransferFormat format) -> TransferStats override;
+    bool startImport(const std::filesystem::path& path, TransferFormat format) override;
+
+    // Audit
+    bool startAudit(const std::filesystem::path& path, AuditFormat format) override;
+    /// Stop a running audit and wait for it; its output file is not written.
+    void cancelAudit();
+
     // Internal: cache management
     void invalidatePlayer(std::string_view uuid) override;
     void invalidateAll() override;
+    void reload() override;
+    void warmUpPlayer(std::string_view uuid) override;
+    /// Drop the warm-up scheduled for a player who has left; one already running evicts what it cached.
+    void cancelWarmUp(std::string_view uuid);
+
+    // Metrics
+    void collectMetrics(utils::metrics::MetricVisitor& visitor) const override;
+    auto getStatementProfiles() const -> std::vector<database::StatementProfile> override;
+
+    /// Configured warm-up nodes followed by the most frequently missed ones.
+    [[nodiscard]] auto getWarmUpNodes() const -> std::vector<std::string>;
+
+    /// Up to `maxEntries` cached decisions, most demanded nodes first, plus the demand counters.
+    [[nodiscard]] auto exportHotDecisions(std::size_t maxEntries) const -> HotDecisions;
+    /// Restore demand counters, and decisions if `hot` was exported from identical data.
+    /// Returns the number of decisions restored.
+    auto importHotDecisions(const HotDecisions& hot) -> std::size_t;
+
+    /// Apply edits other servers committed to the shared database since the last call. Each change
+    /// log entry re-reads only the rows it names and evicts only the decisions they can affect; a
+    /// full reload is done instead when entries were trimmed before this server saw them, when one of
+    /// them is a ChangeKind::Reload, or when more than kMaxTargetedChanges arrived at once.
+    void syncRemoteChanges();
+    /// Delete change log entries older than `retention`; returns how many.
+    auto trimChangeLog(std::chrono::seconds retention) const -> int;
 
 private:
-    auto buildToken(SubjectKind kind, std::string_view uuid) const -> AccessToken;
-    auto resolvePermission(std::string_view playerUuid, std::string_view node) const -> AccessMask;
+    // Blocks until the background load started by loadSnapshotAsync() has finished.
+    auto snapshot() const -> std::shared_ptr<const PermissionSnapshot>;
+    void publish(std::shared_ptr<const PermissionSnapshot> next) const;
+
+    // Answer checks from `image` while the snapshot is loaded from the database on asyncPool_.
+    void loadSnapshotAsync(std::shared_ptr<const SnapshotImage> image);
+    void scheduleImageWrite() const;
+
+    // Re-read rows touched by a committed write and publish them in a new snapshot.
+    // Callers must hold writeMutex_.
+    void refreshGroup(std::string_view groupUuid) const;
+    void refreshMemberships(std::string_view playerUuid) const;
+    void refreshNodeACL(std::string_view node) const;
+
+    using DecisionMap = StringMap<AccessMask>; // node → decision
+
+    // Cached state of one player. Decisions are a pure function of the token's group set unless an
+    // ACE names the player directly, so `decisions` is shared by every player with the same group
+    // set, or private to the player when `personal` is set.
+    struct PlayerEntry {
+        std::shared_ptr<const AccessToken> token;
+        std::shared_ptr<DecisionMap>       decisions; // null if an invalidation raced the lookup
+        bool                               personal{false};
+    };
+
+    // Only membership and hierarchy edits, or an ACL edit that changes `personal`, evict an entry.
+    auto getPlayerEntry(std::string_view playerUuid) const -> PlayerEntry;
+
+    // Sorted, comma-terminated group uuids of the token; the key of sharedDecisions_.
+    static auto tokenSignature(const AccessToken& token) -> std::string;
+
+    // Evict cached decisions that can resolve through `node`: the node itself and its descendants, or for
+    // a wildcard pattern everything below its literal prefix.
+    void invalidateSubtree(std::string_view node);
+
+    // Evict every cached player whose token contains `groupUuid`, and the shared decisions of group
+    // sets containing it. Tokens hold all ancestors of a player's groups, so this covers members of
+    // the group and of all its descendant groups.
+    void invalidateGroupMembers(std::string_view groupUuid);
+    void evictPlayerLocked(std::string_view uuid); // requires cacheMutex_ held exclusively
+
+    auto checkPermissionsImpl(
+        std::string_view                  playerUuid,
+        std::span<const std::string_view> nodes,
+        bool                              recordDemand
+    ) -> std::vector<AccessMask>;
+    void recordDemandLocked(std::string_view node); // requires cacheMutex_ held exclusively
+
+    // A warm-up scheduled by warmUpPlayer() runs once, on the pool or inline on the player's first cache
+    // miss, whichever claims it first; so hot nodes are resolved by the time that first check returns.
+    // cancelWarmUp() cancels it, and a warm-up that was already running then drops what it cached.
+    struct PendingWarmUp {
+        std::uint64_t ticket;
+        bool          claimed{false};
+    };
+    auto claimWarmUp(std::string_view uuid) -> std::optional<std::uint64_t>;
+    void runWarmUp(std::string_view uuid, std::uint64_t ticket);
+    bool runPendingWarmUp(std::string_view uuid); // on a cache miss; true if it ran one
+
+    auto findCachedDecision(std::string_view playerUuid, std::string_view node, uint64_t& gen) const
+        -> std::optional<AccessMask>;
+    auto resolveWithToken(const PermissionSnapshot& snap, const AccessToken& token, std::string_view node) const
+        -> AccessMask;
     bool wouldCreateCycle(std::string_view groupUuid, std::string_view parentUuid) const;
 
+    static constexpr std::size_t   kMaxTrackedNodes     = 4096;
+    static constexpr std::uint32_t kDemandDecayInterval = 8192;
+    static constexpr std::size_t   kMaxTargetedChanges  = 64;
+
+    PermissionManagerOptions             options_;
     std::unique_ptr<database::IDatabase> db_;
     data::PermissionRepository           repo_;
 
-    mutable std::shared_mutex                                                    cacheMutex_;
-    uint64_t                                                                     cacheGeneration_{0};
-    std::unordered_map<std::string, std::unordered_map<std::string, AccessMask>> cache_;
+    // In-memory model; checks read it without locking, writers serialize on writeMutex_.
+    mutable std::mutex                                             writeMutex_;
+    mutable std::atomic<std::shared_ptr<const PermissionSnapshot>> snapshot_;
+    std::int64_t                                                   syncedChangeId_{0}; // guarded by writeMutex_
+
+    mutable std::shared_mutex                             cacheMutex_;
+    uint64_t                                              cacheGeneration_{0};
+    mutable StringMap<PlayerEntry>                        players_;
+    mutable StringMap<std::shared_ptr<DecisionMap>>       sharedDecisions_; // token signature → decisions
+    mutable StringMap<std::unordered_set<std::string>>    groupPlayers_; // group → cached players
+    StringMap<std::uint32_t>                              nodeDemand_;   // node → recent cold resolutions
+    std::uint32_t                                         demandSamples_{0};
+    StringMap<PendingWarmUp>                              pendingWarmUps_; // player → unfinished warm-up
+    std::uint64_t                                         warmUpTickets_{0};
+    std::atomic<std::size_t>                              pendingWarmUpCount_{0}; // read without cacheMutex_
+
+    // Set until the startup load publishes snapshot_; cache misses are resolved from it meanwhile,
+    // and those decisions are not cached.
+    std::atomic<std::shared_ptr<const SnapshotImage>> bootImage_;
+    std::shared_future<void>                          snapshotLoaded_;
+    mutable std::atomic<bool>                         imageWritePending_{false};
+    mutable std::mutex                                imageWriteMutex_;
+
+    // Lock-free counters behind collectMetrics(). Hits are counted but not timed, to keep the hit
+    // path to a lookup and an increment.
+    struct Metrics {
+        utils::metrics::Counter          cacheHits;
+        utils::metrics::Counter          cacheMisses;
+        utils::metrics::Counter          imageChecks;    // misses answered by bootImage_
+        utils::metrics::LatencyHistogram missLatency;    // checkPermission calls that missed the cache
+        utils::metrics::LatencyHistogram resolveLatency; // one ACL evaluation against a token
+        utils::metrics::Counter          playerInvalidations;
+        utils::metrics::Counter          groupInvalidations;
+        utils::metrics::Counter          subtreeInvalidations;
+        utils::metrics::Counter          fullInvalidations;
+        utils::metrics::Counter          remoteChanges; // change log entries applied by syncRemoteChanges()
+        utils::metrics::Counter          syncReloads;   // full reloads it fell back to
+    };
+    mutable Metrics metrics_;
+
+    // The running or last finished audit; it works on the snapshot taken by startAudit().
+    std::atomic<bool> auditRunning_{false};
+    std::jthread      auditJob_;
+
+    std::atomic<bool> importRunning_{false}; // importJob_ is declared after asyncPool_
+
+    // Resolves checkPermissionAsync misses, the startup load and image writes. Declared last so it is
+    // joined before the state it uses goes away.
+    mutable utils::thread::ThreadPool asyncPool_;
+
+    // The running or last finished startImport(). It publishes snapshots, which schedules image writes
+    // on asyncPool_, so it is declared after the pool and joined first.
+    std::jthread importJob_;
 };
 
 } // namespace BakaPerms::core
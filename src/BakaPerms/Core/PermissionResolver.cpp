@@ -1,30 +1,22 @@
 #include "BakaPerms/Core/PermissionResolver.hpp"
 
+#include "BakaPerms/Core/NodePattern.hpp"
 #include "BakaPerms/Utils/Exception/Exceptions.hpp"
 
 namespace BakaPerms::core {
 
-auto PermissionResolver::resolve(
-    const std::string_view requestedNode,
-    const AccessToken&     token,
-    const ACLProvider&     getNodeACL
-) -> AccessMask {
-    for (const auto nodePath = buildNodePath(requestedNode); const auto& node : nodePath) {
-        auto acl = getNodeACL(node);
-        if (acl.empty()) continue; // No ACL at this level, go up
-
-        // ACL exists，iterate in order, first matching trustee wins
-        for (const auto& ace : acl) {
-            if (ace.subjectUuid == "*" || token.contains(ace.subjectUuid)) {
-                return ace.mask;
-            }
-        }
+auto PermissionResolver::resolve(const std::span<const ACE> nearestACL, const AccessToken& token) -> AccessMask {
+    // No node in hierarchy has any ACL, default deny
+    if (nearestACL.empty()) return AccessMask::Deny;
 
-        // ACL exists but no ACE matched the token, implicit deny
-        return AccessMask::Deny;
+    // ACL exists，iterate in order, first matching trustee wins
+    for (const auto& ace : nearestACL) {
+        if (ace.subjectUuid == "*" || token.contains(ace.subjectUuid)) {
+            return ace.mask;
+        }
     }
 
-    // No node in hierarchy has any ACL, default deny
+    // ACL exists but no ACE matched the token, implicit deny
     return AccessMask::Deny;
 }
 
@@ -55,7 +47,8 @@ auto PermissionResolver::buildNodePath(std::string_view node) -> std::vector<std
 auto PermissionResolver::resolveWithTrace(
     const std::string_view requestedNode,
     const AccessToken&     token,
-    const ACLProvider&     getNodeACL
+    const ACLProvider&     getNodeACL,
+    const PatternACL&      pattern
 ) -> PermissionTrace {
     PermissionTrace trace;
     trace.requestedNode = requestedNode;
@@ -64,40 +57,45 @@ auto PermissionResolver::resolveWithTrace(
     const auto nodePath = buildNodePath(requestedNode);
     trace.nodePath      = nodePath;
 
-    for (const auto& node : nodePath) {
-        TraceStep step;
-        step.node = node;
-
-        auto acl = getNodeACL(node);
-        if (acl.empty()) {
-            step.aclFound = false;
-            trace.steps.push_back(step);
-            continue;
-        }
-
+    // The first ACL found decides: first matching ACE, or implicit deny.
+    const auto evaluate = [&trace, &token](TraceStep step, const std::span<const ACE> acl) {
         step.aclFound = true;
-        step.acl      = acl;
+        step.acl.assign(acl.begin(), acl.end());
+        trace.finalResult = AccessMask::Deny;
 
         for (std::size_t i = 0; i < acl.size(); ++i) {
             if (acl[i].subjectUuid == "*") {
                 step.matchedAceIdx    = static_cast<int>(i);
                 step.matchedTokenKind = TokenEntryKind::Wildcard;
-                trace.steps.push_back(step);
-                trace.finalResult = acl[i].mask;
-                return trace;
+                trace.finalResult     = acl[i].mask;
+                break;
             }
             if (auto* entry = token.find(acl[i].subjectUuid)) {
                 step.matchedAceIdx    = static_cast<int>(i);
                 step.matchedTokenKind = entry->kind;
-                trace.steps.push_back(step);
-                trace.finalResult = acl[i].mask;
-                return trace;
+                trace.finalResult     = acl[i].mask;
+                break;
             }
         }
+        trace.steps.push_back(std::move(step));
+    };
 
-        // ACL exists but no ACE matched → implicit deny
-        trace.steps.push_back(step);
-        trace.finalResult = AccessMask::Deny;
+    for (std::size_t i = 0; i < nodePath.size(); ++i) {
+        const auto& node  = nodePath[i];
+        const auto  depth = static_cast<std::uint32_t>(nodePath.size() - 1 - i); // "*" is depth 0
+
+        if (!pattern.acl.empty() && NodePatternMatcher::outranksLiteral(pattern.literalSegments, depth)) {
+            evaluate({.node = std::string(pattern.pattern), .pattern = true}, pattern.acl);
+            return trace;
+        }
+
+        // A node with wildcard segments is a pattern, never a literal ACL of the requested node.
+        const auto acl = NodePatternMatcher::isPattern(node) ? std::span<const ACE>{} : getNodeACL(node);
+        if (acl.empty()) {
+            trace.steps.push_back({.node = node});
+            continue;
+        }
+        evaluate({.node = node}, acl);
         return trace;
     }
 
@@ -1,7 +1,9 @@
 #pragma once
 #include "BakaPerms/Core/Types.hpp"
 
+#include <cstdint>
 #include <functional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -10,23 +12,35 @@ namespace BakaPerms::core {
 
 class PermissionResolver {
 public:
-    using ACLProvider = std::function<std::vector<ACE>(std::string_view)>;
+    /// Returns the ACL attached to exactly the given node; an empty span means no ACL.
+    using ACLProvider = std::function<std::span<const ACE>(std::string_view)>;
 
-    /// DACL resolution: walk up node hierarchy, find first node with an ACL,
-    /// iterate ACEs in order, first matching trustee in token wins.
+    /// The wildcard pattern that applies to a node, see NodePatternMatcher. An empty `acl` means none.
+    struct PatternACL {
+        std::string_view     pattern;
+        std::span<const ACE> acl;
+        std::uint32_t        literalSegments{0};
+    };
+
+    /// DACL evaluation of the nearest ACL found by walking up the node hierarchy
+    /// (see NodeTrie::findNearestACL): iterate ACEs in order, first matching trustee in token wins.
     /// If ACL exists but no ACE matches token → Deny (implicit deny).
-    /// If no node in hierarchy has an ACL → Deny (default deny).
-    static auto resolve(std::string_view requestedNode, const AccessToken& token, const ACLProvider& getNodeACL)
-        -> AccessMask;
+    /// If no node in hierarchy has an ACL (empty span) → Deny (default deny).
+    static auto resolve(std::span<const ACE> nearestACL, const AccessToken& token) -> AccessMask;
 
     /// Build the node lookup path: exact node → parent levels → "*" root.
     /// e.g., "baka.perms.test" → ["baka.perms.test", "baka.perms", "baka", "*"]
+    /// Wildcard patterns are matched separately, by the NodePatternMatcher the ACL index compiles.
     static auto buildNodePath(std::string_view node) -> std::vector<std::string>;
 
-    /// Same as resolve(), but returns a detailed trace of each step for debugging.
-    static auto
-    resolveWithTrace(std::string_view requestedNode, const AccessToken& token, const ACLProvider& getNodeACL)
-        -> PermissionTrace;
+    /// Same as resolve(), but returns a detailed trace of each step for debugging. A non-empty `pattern`
+    /// is inserted into the walk at the first level it outranks; pattern nodes on the path are skipped.
+    static auto resolveWithTrace(
+        std::string_view   requestedNode,
+        const AccessToken& token,
+        const ACLProvider& getNodeACL,
+        const PatternACL&  pattern
+    ) -> PermissionTrace;
 };
 
 } // namespace BakaPerms::core
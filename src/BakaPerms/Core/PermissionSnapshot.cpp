@@ -0,0 +1,243 @@
+#include "BakaPerms/Core/PermissionSnapshot.hpp"
+
+#include <unordered_set>
+
+namespace BakaPerms::core {
+
+// Same bound as the recursive CTE in PermissionRepository::getGroupAncestry.
+constexpr std::size_t kMaxAncestryDepth = 32;
+
+PermissionSnapshot::PermissionSnapshot(
+    GroupMap            groups,
+    MembershipMap       memberships,
+    ACLMap              acls,
+    const std::uint64_t revision
+)
+: PermissionSnapshot(std::move(groups), std::move(memberships), acls, buildACLIndex(acls), revision) {}
+
+PermissionSnapshot::PermissionSnapshot(
+    GroupMap            groups,
+    MembershipMap       memberships,
+    ACLMap              acls,
+    ACLIndex            aclIndex,
+    const std::uint64_t revision
+)
+: groups_(std::move(groups)),
+  memberships_(std::move(memberships)),
+  acls_(std::move(acls)),
+  aclIndex_(std::move(aclIndex)),
+  revision_(revision) {}
+
+auto PermissionSnapshot::buildACLIndex(const ACLMap& acls) -> ACLIndex {
+    ACLIndex index;
+    for (const auto& [node, acl] : acls) {
+        index.trie.assign(node, acl);
+        countSubjects(index.subjects, acl, true);
+    }
+    index.trie.compilePatterns();
+    return index;
+}
+
+void PermissionSnapshot::countSubjects(
+    PersistentStringMap<std::uint32_t>& subjects,
+    const std::span<const ACE>          acl,
+    const bool                          add
+) {
+    for (const auto& ace : acl) {
+        if (ace.subjectUuid == "*") continue;
+        const auto* count = subjects.find(ace.subjectUuid);
+        if (add) {
+            subjects.set(ace.subjectUuid, count ? *count + 1 : 1);
+        } else if (count && *count > 1) {
+            subjects.set(ace.subjectUuid, *count - 1);
+        } else {
+            subjects.erase(ace.subjectUuid);
+        }
+    }
+}
+
+auto PermissionSnapshot::load(const data::PermissionRepository& repo, const std::uint64_t revision)
+    -> std::shared_ptr<const PermissionSnapshot> {
+    // One batch, so groups, memberships and ACLs come from the same state of the database.
+    auto state = repo.loadAll();
+
+    GroupMap groups;
+    for (auto& group : state.groups) {
+        auto uuid = group.uuid;
+        groups.set(std::move(uuid), std::move(group));
+    }
+
+    MembershipMap memberships;
+    for (auto& [player, groupUuids] : state.memberships) {
+        memberships.set(player, std::move(groupUuids));
+    }
+
+    ACLMap acls;
+    for (auto& [node, acl] : state.acls) {
+        acls.set(node, std::move(acl));
+    }
+
+    return std::make_shared<const PermissionSnapshot>(
+        std::move(groups),
+        std::move(memberships),
+        std::move(acls),
+        revision
+    );
+}
+
+auto PermissionSnapshot::withGroups(GroupMap groups) const -> std::shared_ptr<const PermissionSnapshot> {
+    return std::shared_ptr<const PermissionSnapshot>(
+        new PermissionSnapshot(std::move(groups), memberships_, acls_, aclIndex_, revision_ + 1)
+    );
+}
+
+auto PermissionSnapshot::withMemberships(MembershipMap memberships) const
+    -> std::shared_ptr<const PermissionSnapshot> {
+    return std::shared_ptr<const PermissionSnapshot>(
+        new PermissionSnapshot(groups_, std::move(memberships), acls_, aclIndex_, revision_ + 1)
+    );
+}
+
+auto PermissionSnapshot::withNodeACL(std::string node, std::vector<ACE> acl) const
+    -> std::shared_ptr<const PermissionSnapshot> {
+    auto acls  = acls_;
+    auto index = aclIndex_;
+    if (const auto* old = acls_.find(node)) countSubjects(index.subjects, *old, false);
+    if (acl.empty()) {
+        index.trie.assign(node, {});
+        acls.erase(node);
+    } else {
+        acls.set(node, std::move(acl));
+        const auto& stored = *acls.find(node);
+        index.trie.assign(node, stored);
+        countSubjects(index.subjects, stored, true);
+    }
+    index.trie.compilePatterns();
+    return std::shared_ptr<const PermissionSnapshot>(
+        new PermissionSnapshot(groups_, memberships_, std::move(acls), std::move(index), revision_ + 1)
+    );
+}
+
+namespace {
+
+// 64-bit FNV-1a; every field is terminated so ("ab","c") and ("a","bc") hash differently.
+class Fnv1a {
+public:
+    void add(const std::string_view bytes) {
+        for (const auto c : bytes) mix(static_cast<unsigned char>(c));
+        mix(0xff);
+    }
+    void add(const int value) { add(std::string_view(reinterpret_cast<const char*>(&value), sizeof(value))); }
+
+    [[nodiscard]] auto value() const -> std::uint64_t { return hash_; }
+
+private:
+    void mix(const unsigned char byte) {
+        hash_ ^= byte;
+        hash_ *= 0x100000001b3ULL;
+    }
+
+    std::uint64_t hash_{0xcbf29ce484222325ULL};
+};
+
+} // namespace
+
+auto PermissionSnapshot::fingerprint() const -> std::uint64_t {
+    // Entries are hashed individually and summed, so map iteration order does not matter.
+    std::uint64_t sum = 0;
+    for (const auto& [uuid, group] : groups_) {
+        Fnv1a h;
+        h.add("group");
+        h.add(uuid);
+        h.add(group.name);
+        h.add(group.parentUuid.value_or(""));
+        sum += h.value();
+    }
+    for (const auto& [player, groupUuids] : memberships_) {
+        Fnv1a h;
+        h.add("member");
+        h.add(player);
+        for (const auto& groupUuid : groupUuids) h.add(groupUuid);
+        sum += h.value();
+    }
+    for (const auto& [node, acl] : acls_) {
+        Fnv1a h;
+        h.add("acl");
+        h.add(node);
+        for (const auto& ace : acl) { // position within the ACL matters, the stored order_index does not
+            h.add(ace.subjectUuid);
+            h.add(ace.subjectType);
+            h.add(static_cast<int>(ace.mask));
+        }
+        sum += h.value();
+    }
+    return sum;
+}
+
+auto PermissionSnapshot::findGroup(const std::string_view uuid) const -> const GroupInfo* {
+    return groups_.find(uuid);
+}
+
+auto PermissionSnapshot::getGroupAncestry(const std::string_view uuid) const -> std::vector<const GroupInfo*> {
+    std::vector<const GroupInfo*>        chain;
+    std::unordered_set<std::string_view> visited;
+    for (auto* group = findGroup(uuid); group && chain.size() <= kMaxAncestryDepth;) {
+        if (!visited.insert(group->uuid).second) break; // cycle detection
+        chain.push_back(group);
+        group = group->parentUuid ? findGroup(*group->parentUuid) : nullptr;
+    }
+    return chain;
+}
+
+auto PermissionSnapshot::getNodeACL(const std::string_view node) const -> std::span<const ACE> {
+    if (const auto* acl = acls_.find(node)) return *acl;
+    return {};
+}
+
+auto PermissionSnapshot::findNearestACL(const std::string_view node) const -> std::span<const ACE> {
+    return aclIndex_.trie.findNearestACL(node);
+}
+
+auto PermissionSnapshot::findPatternACL(const std::string_view node) const -> PermissionResolver::PatternACL {
+    const auto hit = aclIndex_.trie.findPattern(node);
+    if (hit.acl.empty()) return {};
+    return {.pattern = hit.pattern, .acl = hit.acl, .literalSegments = hit.literalSegments};
+}
+
+auto PermissionSnapshot::isACESubject(const std::string_view uuid) const -> bool {
+    return aclIndex_.subjects.contains(uuid);
+}
+
+auto PermissionSnapshot::buildToken(const SubjectKind kind, const std::string_view uuid) const -> AccessToken {
+    AccessToken token;
+
+    if (kind == SubjectKind::Player) {
+        token.add(std::string(uuid), TokenEntryKind::Subject);
+        const auto* groupUuids = memberships_.find(uuid);
+        if (!groupUuids) return token;
+        // First pass: add all direct groups so they are never mislabeled as InheritedGroup
+        for (const auto& groupUuid : *groupUuids) {
+            if (findGroup(groupUuid)) token.add(groupUuid, TokenEntryKind::DirectGroup);
+        }
+        // Second pass: climb each parent chain once. Stopping at the first group already in the
+        // token is safe: its own ancestors were (or will be) added by the walk that reached it.
+        for (const auto& groupUuid : *groupUuids) {
+            const auto* group = findGroup(groupUuid);
+            for (std::size_t depth = 0; group && group->parentUuid && depth < kMaxAncestryDepth; ++depth) {
+                group = findGroup(*group->parentUuid);
+                if (!group || token.contains(group->uuid)) break;
+                token.add(group->uuid, TokenEntryKind::InheritedGroup);
+            }
+        }
+    } else {
+        // Group: the group itself + its ancestry
+        const auto ancestry = getGroupAncestry(uuid);
+        for (std::size_t i = 0; i < ancestry.size(); ++i) {
+            token.add(ancestry[i]->uuid, i == 0 ? TokenEntryKind::Subject : TokenEntryKind::InheritedGroup);
+        }
+    }
+
+    return token;
+}
+
+} // namespace BakaPerms::core
@@ -0,0 +1,98 @@
+#pragma once
+#include "BakaPerms/Core/NodeTrie.hpp"
+#include "BakaPerms/Core/PersistentStringMap.hpp"
+#include "BakaPerms/Core/PermissionResolver.hpp"
+#include "BakaPerms/Core/Types.hpp"
+#include "BakaPerms/Data/PermissionRepository.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BakaPerms::core {
+
+/// Immutable in-memory copy of the groups, player_groups and permissions tables.
+/// PermissionManager publishes a new instance after every mutation; readers keep the
+/// shared_ptr they loaded and never observe a partially applied change. The tables are
+/// persistent maps, so a derived instance shares every entry the mutation did not touch.
+class PermissionSnapshot {
+public:
+    using GroupMap = PersistentStringMap<GroupInfo>;
+    // player uuid → direct group uuids, by group name
+    using MembershipMap = PersistentStringMap<std::vector<std::string>>;
+    // node → ACEs, by order_index
+    using ACLMap = PersistentStringMap<std::vector<ACE>>;
+
+    PermissionSnapshot(GroupMap groups, MembershipMap memberships, ACLMap acls, std::uint64_t revision);
+
+    /// Load every table from the repository.
+    static auto load(const data::PermissionRepository& repo, std::uint64_t revision = 0)
+        -> std::shared_ptr<const PermissionSnapshot>;
+
+    // Copy-on-write derivations: the replaced table is swapped in, the others are shared.
+    [[nodiscard]] auto withGroups(GroupMap groups) const -> std::shared_ptr<const PermissionSnapshot>;
+    [[nodiscard]] auto withMemberships(MembershipMap memberships) const -> std::shared_ptr<const PermissionSnapshot>;
+    /// Replace the ACL of `node`, removing it if `acl` is empty. The ACL index is updated for this node only;
+    /// wildcard patterns are recompiled only if `node` is one.
+    [[nodiscard]] auto withNodeACL(std::string node, std::vector<ACE> acl) const
+        -> std::shared_ptr<const PermissionSnapshot>;
+
+    [[nodiscard]] auto groups() const -> const GroupMap& { return groups_; }
+    [[nodiscard]] auto memberships() const -> const MembershipMap& { return memberships_; }
+    [[nodiscard]] auto acls() const -> const ACLMap& { return acls_; }
+    [[nodiscard]] auto revision() const noexcept -> std::uint64_t { return revision_; }
+
+    /// Order-independent hash of every table. Equal fingerprints mean decisions resolved against one
+    /// snapshot are valid for the other, e.g. across a restart.
+    [[nodiscard]] auto fingerprint() const -> std::uint64_t;
+
+    [[nodiscard]] auto findGroup(std::string_view uuid) const -> const GroupInfo*;
+
+    /// The group itself followed by its parent chain, stopping at cycles or after 32 levels.
+    [[nodiscard]] auto getGroupAncestry(std::string_view uuid) const -> std::vector<const GroupInfo*>;
+
+    /// ACEs attached to exactly `node`, or an empty span if it has no ACL.
+    [[nodiscard]] auto getNodeACL(std::string_view node) const -> std::span<const ACE>;
+
+    /// ACL of the nearest ACL-bearing node on the path node → parents → "*", or of a wildcard pattern
+    /// that outranks it (see NodePatternMatcher). Empty span if neither exists.
+    [[nodiscard]] auto findNearestACL(std::string_view node) const -> std::span<const ACE>;
+
+    /// Highest-ranked wildcard pattern matching `node` or one of its ancestors, for tracing.
+    [[nodiscard]] auto findPatternACL(std::string_view node) const -> PermissionResolver::PatternACL;
+
+    /// True if some ACE names `uuid` as its subject. Players for whom this holds cannot share
+    /// decisions with other players that have the same groups.
+    [[nodiscard]] auto isACESubject(std::string_view uuid) const -> bool;
+
+    [[nodiscard]] auto buildToken(SubjectKind kind, std::string_view uuid) const -> AccessToken;
+
+private:
+    /// Interned view of acls_; the trie's spans point into acls_ entries.
+    struct ACLIndex {
+        NodeTrie                           trie;
+        PersistentStringMap<std::uint32_t> subjects; // ACEs naming each subject, except "*"
+    };
+
+    PermissionSnapshot(
+        GroupMap      groups,
+        MembershipMap memberships,
+        ACLMap        acls,
+        ACLIndex      aclIndex,
+        std::uint64_t revision
+    );
+
+    static auto buildACLIndex(const ACLMap& acls) -> ACLIndex;
+    static void countSubjects(PersistentStringMap<std::uint32_t>& subjects, std::span<const ACE> acl, bool add);
+
+    GroupMap      groups_;
+    MembershipMap memberships_;
+    ACLMap        acls_;
+    ACLIndex      aclIndex_;
+    std::uint64_t revision_;
+};
+
+} // namespace BakaPerms::core
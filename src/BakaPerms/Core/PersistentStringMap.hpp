@@ -0,0 +1,289 @@
+#pragma once
+#include "BakaPerms/Core/Types.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace BakaPerms::core {
+
+/// String-keyed hash array mapped trie with structural sharing. Copies are O(1) and share every node;
+/// set() and erase() copy only the shared nodes on the path to the key, at most one per 5 bits of the
+/// hash, so deriving an edited copy of a large map costs O(log n) regardless of its size. Entries are
+/// immutable and shared, so references to them stay valid for as long as any copy holding them does.
+///
+/// Not thread-safe for concurrent mutation, like any value type; concurrent reads of copies are fine.
+template <typename Value>
+class PersistentStringMap {
+public:
+    using value_type = std::pair<const std::string, Value>;
+
+    class const_iterator;
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+    [[nodiscard]] auto empty() const noexcept -> bool { return size_ == 0; }
+
+    /// Value stored under `key`, or nullptr.
+    [[nodiscard]] auto find(const std::string_view key) const -> const Value* {
+        const auto  hash = StringHash{}(key);
+        const auto* node = root_.get();
+        for (unsigned shift = 0; node; shift += kBits) {
+            if (shift >= kHashBits) {
+                for (const auto& entry : node->entries) {
+                    if (entry->first == key) return &entry->second;
+                }
+                return nullptr;
+            }
+            const auto bit = bitFor(hash, shift);
+            if (node->entryMap & bit) {
+                const auto& entry = node->entries[indexOf(node->entryMap, bit)];
+                return entry->first == key ? &entry->second : nullptr;
+            }
+            if (!(node->nodeMap & bit)) return nullptr;
+            node = node->children[indexOf(node->nodeMap, bit)].get();
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] auto contains(const std::string_view key) const -> bool { return find(key) != nullptr; }
+
+    /// Insert `key`, or replace its value.
+    void set(std::string key, Value value) {
+        const auto hash  = StringHash{}(key);
+        auto       entry = std::make_shared<const value_type>(std::move(key), std::move(value));
+        bool       added = false;
+        insert(root_, std::move(entry), hash, 0, added);
+        if (added) ++size_;
+    }
+
+    /// Remove `key`; false if it was not present.
+    auto erase(const std::string_view key) -> bool {
+        if (!root_) return false;
+        bool removed = false;
+        root_        = remove(root_, key, StringHash{}(key), 0, removed);
+        if (removed) --size_;
+        return removed;
+    }
+
+    [[nodiscard]] auto begin() const -> const_iterator { return const_iterator(root_.get()); }
+    [[nodiscard]] auto end() const -> const_iterator { return {}; }
+
+private:
+    struct Node;
+    using EntryPtr = std::shared_ptr<const value_type>;
+    using NodePtr  = std::shared_ptr<const Node>;
+
+    // A node below the last hash level is a collision bucket: both bitmaps are zero and `entries`
+    // holds every key with that full hash, unordered.
+    struct Node {
+        std::uint32_t         entryMap{0}; // hash slots holding an entry
+        std::uint32_t         nodeMap{0};  // hash slots holding a child
+        std::vector<EntryPtr> entries;     // by slot
+        std::vector<NodePtr>  children;    // by slot
+    };
+
+    static constexpr unsigned    kBits     = 5;
+    static constexpr unsigned    kHashBits = std::numeric_limits<std::size_t>::digits;
+    static constexpr std::size_t kMaxDepth = kHashBits / kBits + 2; // hash levels plus the bucket
+
+    static auto bitFor(const std::size_t hash, const unsigned shift) -> std::uint32_t {
+        return std::uint32_t{1} << ((hash >> shift) & ((1u << kBits) - 1));
+    }
+    static auto indexOf(const std::uint32_t map, const std::uint32_t bit) -> std::size_t {
+        return static_cast<std::size_t>(std::popcount(map & (bit - 1)));
+    }
+
+    /// The node at `slot` for modification: the node itself if this map is its only owner, so a map being
+    /// built does not copy its own nodes, or else a copy put in its place. Shared nodes are never modified.
+    static auto own(NodePtr& slot) -> Node& {
+        if (slot.use_count() == 1) {
+            // Pairs with the release in the last other owner's destructor: its reads happen before our writes.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return const_cast<Node&>(*slot);
+        }
+        auto  copy = slot ? std::make_shared<Node>(*slot) : std::make_shared<Node>();
+        auto& node = *copy;
+        slot       = std::move(copy);
+        return node;
+    }
+
+    static void insert(NodePtr& slot, EntryPtr entry, const std::size_t hash, const unsigned shift, bool& added) {
+        auto& node = own(slot);
+        if (shift >= kHashBits) {
+            for (auto& existing : node.entries) {
+                if (existing->first == entry->first) {
+                    existing = std::move(entry);
+                    return;
+                }
+            }
+            node.entries.push_back(std::move(entry));
+            added = true;
+            return;
+        }
+
+        const auto bit = bitFor(hash, shift);
+        if (node.nodeMap & bit) {
+            insert(node.children[indexOf(node.nodeMap, bit)], std::move(entry), hash, shift + kBits, added);
+        } else if (node.entryMap & bit) {
+            const auto index = indexOf(node.entryMap, bit);
+            if (node.entries[index]->first == entry->first) {
+                node.entries[index] = std::move(entry);
+                return;
+            }
+            // Two keys share this slot: push both one level down.
+            auto       existing     = std::move(node.entries[index]);
+            const auto existingHash = StringHash{}(existing->first);
+            node.entries.erase(node.entries.begin() + static_cast<std::ptrdiff_t>(index));
+            node.entryMap &= ~bit;
+            NodePtr child;
+            bool    ignored = false;
+            insert(child, std::move(existing), existingHash, shift + kBits, ignored);
+            insert(child, std::move(entry), hash, shift + kBits, added);
+            node.nodeMap |= bit;
+            node.children.insert(
+                node.children.begin() + static_cast<std::ptrdiff_t>(indexOf(node.nodeMap, bit)),
+                std::move(child)
+            );
+        } else {
+            node.entryMap |= bit;
+            node.entries.insert(
+                node.entries.begin() + static_cast<std::ptrdiff_t>(indexOf(node.entryMap, bit)),
+                std::move(entry)
+            );
+            added = true;
+        }
+    }
+
+    // Returns `node` itself if `key` is absent, and nullptr once a node is left empty.
+    static auto remove(
+        const NodePtr&         node,
+        const std::string_view key,
+        const std::size_t      hash,
+        const unsigned         shift,
+        bool&                  removed
+    ) -> NodePtr {
+        if (shift >= kHashBits) {
+            for (std::size_t i = 0; i < node->entries.size(); ++i) {
+                if (node->entries[i]->first != key) continue;
+                auto copy = std::make_shared<Node>(*node);
+                copy->entries.erase(copy->entries.begin() + static_cast<std::ptrdiff_t>(i));
+                removed = true;
+                return copy->entries.empty() ? nullptr : NodePtr(std::move(copy));
+            }
+            return node;
+        }
+
+        const auto            bit = bitFor(hash, shift);
+        std::shared_ptr<Node> copy;
+        if (node->entryMap & bit) {
+            const auto index = indexOf(node->entryMap, bit);
+            if (node->entries[index]->first != key) return node;
+            copy = std::make_shared<Node>(*node);
+            copy->entries.erase(copy->entries.begin() + static_cast<std::ptrdiff_t>(index));
+            copy->entryMap &= ~bit;
+            removed         = true;
+        } else if (node->nodeMap & bit) {
+            const auto index = indexOf(node->nodeMap, bit);
+            auto       child = remove(node->children[index], key, hash, shift + kBits, removed);
+            if (!removed) return node;
+            copy = std::make_shared<Node>(*node);
+            if (child && !(child->children.empty() && child->entries.size() == 1)) {
+                copy->children[index] = std::move(child);
+            } else {
+                // Empty or down to one entry: drop the child, pulling its entry up into this slot.
+                copy->children.erase(copy->children.begin() + static_cast<std::ptrdiff_t>(index));
+                copy->nodeMap &= ~bit;
+                if (child) {
+                    copy->entryMap |= bit;
+                    copy->entries.insert(
+                        copy->entries.begin() + static_cast<std::ptrdiff_t>(indexOf(copy->entryMap, bit)),
+                        child->entries.front()
+                    );
+                }
+            }
+        } else {
+            return node;
+        }
+        return copy->entryMap == 0 && copy->nodeMap == 0 ? nullptr : NodePtr(std::move(copy));
+    }
+
+    NodePtr     root_;
+    std::size_t size_{0};
+};
+
+/// Forward iterator in unspecified order: each node's entries, then its children depth-first.
+template <typename Value>
+class PersistentStringMap<Value>::const_iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = PersistentStringMap::value_type;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const value_type*;
+    using reference         = const value_type&;
+
+    const_iterator() = default;
+
+    auto operator*() const -> reference { return *current_; }
+    auto operator->() const -> pointer { return current_; }
+
+    auto operator++() -> const_iterator& {
+        advance();
+        return *this;
+    }
+    auto operator++(int) -> const_iterator {
+        auto copy = *this;
+        advance();
+        return copy;
+    }
+
+    friend auto operator==(const const_iterator& a, const const_iterator& b) -> bool {
+        return a.current_ == b.current_;
+    }
+
+private:
+    friend class PersistentStringMap;
+
+    struct Frame {
+        const Node* node;
+        std::size_t entry;
+        std::size_t child;
+    };
+
+    explicit const_iterator(const Node* root) {
+        if (!root) return;
+        stack_[depth_++] = {.node = root, .entry = 0, .child = 0};
+        advance();
+    }
+
+    void advance() {
+        while (depth_ > 0) {
+            auto& frame = stack_[depth_ - 1];
+            if (frame.entry < frame.node->entries.size()) {
+                current_ = frame.node->entries[frame.entry++].get();
+                return;
+            }
+            if (frame.child < frame.node->children.size()) {
+                const auto* child = frame.node->children[frame.child++].get();
+                stack_[depth_++]  = {.node = child, .entry = 0, .child = 0};
+                continue;
+            }
+            --depth_;
+        }
+        current_ = nullptr;
+    }
+
+    std::array<Frame, kMaxDepth> stack_{};
+    std::size_t                  depth_{0};
+    const value_type*            current_{nullptr};
+};
+
+} // namespace BakaPerms::core
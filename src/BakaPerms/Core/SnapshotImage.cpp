@@ -0,0 +1,268 @@
+#include "BakaPerms/Core/SnapshotImage.hpp"
+
+#include "BakaPerms/Utils/Exception/Exceptions.hpp"
+#include "BakaPerms/Utils/IO/BinaryStream.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace BakaPerms::core {
+
+// Layout: Header, player slots, ACL slots, group refs, ACE records, string blob.
+// Section sizes follow from the counts in the header, so the file has no offsets to validate.
+constexpr char          kMagic[4] = {'B', 'P', 'S', 'I'};
+constexpr std::uint32_t kVersion  = 1;
+
+namespace {
+
+// 64-bit FNV-1a, used for both the checksum and the hash tables.
+class Fnv1a {
+public:
+    void add(const std::span<const std::byte> bytes) {
+        for (const auto b : bytes) {
+            hash_ ^= static_cast<std::uint64_t>(b);
+            hash_ *= 0x100000001b3ULL;
+        }
+    }
+    void add(const std::string_view str) { add(std::as_bytes(std::span(str))); }
+
+    [[nodiscard]] auto value() const -> std::uint64_t { return hash_; }
+
+private:
+    std::uint64_t hash_{0xcbf29ce484222325ULL};
+};
+
+auto hashKey(const std::string_view key) -> std::uint64_t {
+    Fnv1a h;
+    h.add(key);
+    return h.value();
+}
+
+} // namespace
+
+void SnapshotImage::write(const std::filesystem::path& path, const PermissionSnapshot& snapshot) {
+    std::string       strings;
+    StringMap<StrRef> interned;
+    const auto        intern = [&](const std::string_view str) {
+        const auto [it, inserted] = interned.try_emplace(
+            std::string(str),
+            StrRef{static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(str.size())}
+        );
+        if (inserted) strings += str;
+        return it->second;
+    };
+
+    // Players: the groups of the token PermissionSnapshot::buildToken resolves, ancestors included.
+    std::vector<Slot>   playerEntries;
+    std::vector<StrRef> groups;
+    for (const auto& [player, groupUuids] : snapshot.memberships()) {
+        const auto first = static_cast<std::uint32_t>(groups.size());
+        for (const auto& [uuid, kind] : snapshot.buildToken(SubjectKind::Player, player).entries()) {
+            if (kind != TokenEntryKind::Subject) groups.push_back(intern(uuid));
+        }
+        if (groups.size() == first) continue; // resolves like a player without memberships
+        playerEntries.push_back({intern(player), first, static_cast<std::uint32_t>(groups.size() - first)});
+    }
+
+    std::vector<Slot>      aclEntries;
+    std::vector<AceRecord> aces;
+    for (const auto& [node, acl] : snapshot.acls()) {
+        const auto first = static_cast<std::uint32_t>(aces.size());
+        for (const auto& ace : acl) {
+            aces.push_back({intern(ace.subjectUuid), static_cast<std::uint32_t>(ace.mask)});
+        }
+        aclEntries.push_back({intern(node), first, static_cast<std::uint32_t>(acl.size())});
+    }
+
+    if (strings.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw utils::exception::OperationFailedException("Snapshot is too large for " + path.string());
+    }
+
+    // At most half full, so every probe sequence reaches an empty slot.
+    const auto buildTable = [&strings](const std::vector<Slot>& entries) {
+        std::vector<Slot> table(std::bit_ceil(std::max<std::size_t>(entries.size() * 2, 1)));
+        const auto        mask = table.size() - 1;
+        for (auto& slot : table) slot.first = kEmptySlot;
+        for (const auto& entry : entries) {
+            auto i = hashKey(std::string_view(strings).substr(entry.key.offset, entry.key.size)) & mask;
+            while (table[i].first != kEmptySlot) i = (i + 1) & mask;
+            table[i] = entry;
+        }
+        return table;
+    };
+    const auto playerTable = buildTable(playerEntries);
+    const auto aclTable    = buildTable(aclEntries);
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version     = kVersion;
+    header.fingerprint = snapshot.fingerprint();
+    header.playerSlots = static_cast<std::uint32_t>(playerTable.size());
+    header.aclSlots    = static_cast<std::uint32_t>(aclTable.size());
+    header.groupRefs   = static_cast<std::uint32_t>(groups.size());
+    header.aceRecords  = static_cast<std::uint32_t>(aces.size());
+    header.stringsSize = static_cast<std::uint32_t>(strings.size());
+
+    Fnv1a checksum;
+    checksum.add(std::as_bytes(std::span(&header, 1)));
+    checksum.add(std::as_bytes(std::span(playerTable)));
+    checksum.add(std::as_bytes(std::span(aclTable)));
+    checksum.add(std::as_bytes(std::span(groups)));
+    checksum.add(std::as_bytes(std::span(aces)));
+    checksum.add(strings);
+    header.checksum = checksum.value();
+
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream           file(tmpPath, std::ios::binary | std::ios::trunc);
+        utils::io::BinaryWriter out(file);
+        out.write(header);
+        out.writeArray(std::span<const Slot>(playerTable));
+        out.writeArray(std::span<const Slot>(aclTable));
+        out.writeArray(std::span<const StrRef>(groups));
+        out.writeArray(std::span<const AceRecord>(aces));
+        out.writeArray(std::span<const char>(strings));
+        if (!file.flush()) {
+            throw utils::exception::OperationFailedException("Failed to write " + tmpPath.string());
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        throw utils::exception::OperationFailedException("Failed to replace " + path.string() + ": " + ec.message());
+    }
+}
+
+auto SnapshotImage::open(const std::filesystem::path& path) -> std::shared_ptr<const SnapshotImage> {
+    auto file = utils::io::MappedFile::open(path);
+    if (!file || file->bytes().size() < sizeof(Header)) return nullptr;
+
+    const auto bytes = file->bytes();
+    Header     header;
+    std::memcpy(&header, bytes.data(), sizeof(Header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) return nullptr;
+
+    const auto expectedSize = sizeof(Header) + std::uint64_t{header.playerSlots} * sizeof(Slot)
+                            + std::uint64_t{header.aclSlots} * sizeof(Slot)
+                            + std::uint64_t{header.groupRefs} * sizeof(StrRef)
+                            + std::uint64_t{header.aceRecords} * sizeof(AceRecord) + header.stringsSize;
+    if (expectedSize != bytes.size()) return nullptr;
+
+    const auto storedChecksum = header.checksum;
+    header.checksum           = 0;
+    Fnv1a checksum;
+    checksum.add(std::as_bytes(std::span(&header, 1)));
+    checksum.add(bytes.subspan(sizeof(Header)));
+    if (checksum.value() != storedChecksum) return nullptr;
+
+    std::shared_ptr<SnapshotImage> image(new SnapshotImage(std::move(file)));
+    if (!image->validate()) return nullptr;
+    image->compilePatterns();
+    return image;
+}
+
+SnapshotImage::SnapshotImage(std::unique_ptr<utils::io::MappedFile> file)
+: file_(std::move(file)),
+  header_(reinterpret_cast<const Header*>(file_->bytes().data())) {
+    // open() has checked that the sections exactly fill the file.
+    const auto* cursor = file_->bytes().data() + sizeof(Header);
+    players_           = {reinterpret_cast<const Slot*>(cursor), header_->playerSlots};
+    cursor            += players_.size_bytes();
+    acls_              = {reinterpret_cast<const Slot*>(cursor), header_->aclSlots};
+    cursor            += acls_.size_bytes();
+    groups_            = {reinterpret_cast<const StrRef*>(cursor), header_->groupRefs};
+    cursor            += groups_.size_bytes();
+    aces_              = {reinterpret_cast<const AceRecord*>(cursor), header_->aceRecords};
+    cursor            += aces_.size_bytes();
+    strings_ = std::string_view(reinterpret_cast<const char*>(cursor), header_->stringsSize);
+}
+
+bool SnapshotImage::validate() const {
+    const auto validRef = [this](const StrRef ref) {
+        return ref.offset <= strings_.size() && ref.size <= strings_.size() - ref.offset;
+    };
+    const auto validTable = [&](const std::span<const Slot> table, const std::size_t targetSize) {
+        if (!std::has_single_bit(table.size())) return false;
+        bool hasEmptySlot = false;
+        for (const auto& slot : table) {
+            if (slot.first == kEmptySlot) {
+                hasEmptySlot = true;
+                continue;
+            }
+            if (!validRef(slot.key) || slot.first > targetSize || slot.count > targetSize - slot.first) return false;
+        }
+        return hasEmptySlot;
+    };
+    return validTable(players_, groups_.size()) && validTable(acls_, aces_.size())
+        && std::ranges::all_of(groups_, validRef)
+        && std::ranges::all_of(aces_, [&](const AceRecord& ace) { return validRef(ace.subject); });
+}
+
+void SnapshotImage::compilePatterns() {
+    std::vector<std::string> patterns;
+    for (std::uint32_t i = 0; i < acls_.size(); ++i) {
+        if (acls_[i].first == kEmptySlot) continue;
+        if (const auto node = str(acls_[i].key); NodePatternMatcher::isPattern(node)) {
+            patterns.emplace_back(node);
+            patternSlots_.push_back(i);
+        }
+    }
+    patterns_ = NodePatternMatcher(std::move(patterns));
+}
+
+auto SnapshotImage::str(const StrRef ref) const -> std::string_view { return strings_.substr(ref.offset, ref.size); }
+
+auto SnapshotImage::find(const std::span<const Slot> table, const std::string_view key) const -> const Slot* {
+    const auto mask = table.size() - 1;
+    for (auto i = hashKey(key) & mask;; i = (i + 1) & mask) {
+        const auto& slot = table[i];
+        if (slot.first == kEmptySlot) return nullptr;
+        if (str(slot.key) == key) return &slot;
+    }
+}
+
+auto SnapshotImage::check(const std::string_view playerUuid, const std::string_view node) const -> AccessMask {
+    if (node.empty()) {
+        throw utils::exception::InvalidArgumentException("Permission node must not be empty");
+    }
+
+    std::span<const StrRef> groups;
+    if (const auto* slot = find(players_, playerUuid)) groups = groups_.subspan(slot->first, slot->count);
+
+    // Nearest literal ACL on the path node → parents → "*", unless a wildcard pattern outranks it,
+    // as in NodeTrie::findNearestACL. Pattern slots never match literally.
+    const Slot*   acl   = nullptr;
+    std::uint32_t depth = 0;
+    for (auto current = node; current != "*";) {
+        if ((patterns_.empty() || !NodePatternMatcher::isPattern(current)) && (acl = find(acls_, current))) {
+            depth = static_cast<std::uint32_t>(std::ranges::count(current, '.')) + 1;
+            break;
+        }
+        const auto pos = current.rfind('.');
+        if (pos == std::string_view::npos) break;
+        current = current.substr(0, pos);
+    }
+    if (!acl) acl = find(acls_, "*");
+    if (const auto match = patterns_.match(node);
+        match.id != NodePatternMatcher::kNoMatch && NodePatternMatcher::outranksLiteral(match.literalSegments, depth)) {
+        acl = &acls_[patternSlots_[match.id]];
+    }
+    if (!acl) return AccessMask::Deny;
+
+    // First matching trustee wins, as in PermissionResolver::resolve.
+    for (const auto& ace : aces_.subspan(acl->first, acl->count)) {
+        const auto subject = str(ace.subject);
+        if (subject == "*" || subject == playerUuid
+            || std::ranges::any_of(groups, [&](const StrRef group) { return str(group) == subject; })) {
+            return static_cast<AccessMask>(ace.mask);
+        }
+    }
+    return AccessMask::Deny;
+}
+
+} // namespace BakaPerms::core
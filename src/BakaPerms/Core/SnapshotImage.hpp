@@ -0,0 +1,87 @@
+#pragma once
+#include "BakaPerms/Core/NodePattern.hpp"
+#include "BakaPerms/Core/PermissionSnapshot.hpp"
+#include "BakaPerms/Core/Types.hpp"
+#include "BakaPerms/Utils/IO/MappedFile.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace BakaPerms::core {
+
+/// Read-only copy of a PermissionSnapshot laid out to be used straight from a memory mapping:
+/// opening it is a checksum pass, and a check is a few hash-table probes into the mapped file.
+/// Wildcard patterns are stored as ordinary ACL slots and compiled when the image is opened.
+/// Lets the mod answer checks at startup while the real snapshot loads from the database.
+class SnapshotImage {
+public:
+    /// Write `snapshot` atomically (temp file + rename). Throws OperationFailedException on I/O errors.
+    static void write(const std::filesystem::path& path, const PermissionSnapshot& snapshot);
+
+    /// Map an image written by write(). Returns null if it is missing, from another format version,
+    /// or fails its checksum or bounds checks.
+    static auto open(const std::filesystem::path& path) -> std::shared_ptr<const SnapshotImage>;
+
+    /// PermissionSnapshot::fingerprint() of the snapshot the image was written from.
+    [[nodiscard]] auto fingerprint() const noexcept -> std::uint64_t { return header_->fingerprint; }
+
+    /// Same decision as resolving `node` against the snapshot with the player's access token.
+    [[nodiscard]] auto check(std::string_view playerUuid, std::string_view node) const -> AccessMask;
+
+private:
+    // On-disk records. Everything is host-endian and 4-byte aligned; strings live in one blob.
+    struct StrRef {
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    // Open-addressing hash table slot. Player slots index group refs, ACL slots index ACE records.
+    struct Slot {
+        StrRef        key;
+        std::uint32_t first; // kEmptySlot if unused
+        std::uint32_t count;
+    };
+
+    struct AceRecord {
+        StrRef        subject;
+        std::uint32_t mask;
+    };
+
+    struct Header {
+        char          magic[4];
+        std::uint32_t version;
+        std::uint64_t fingerprint;
+        std::uint64_t checksum; // FNV-1a of the file with this field zeroed
+        std::uint32_t playerSlots;
+        std::uint32_t aclSlots;
+        std::uint32_t groupRefs;
+        std::uint32_t aceRecords;
+        std::uint32_t stringsSize;
+        std::uint32_t reserved;
+    };
+
+    static constexpr std::uint32_t kEmptySlot = 0xffffffff;
+
+    explicit SnapshotImage(std::unique_ptr<utils::io::MappedFile> file);
+
+    [[nodiscard]] bool validate() const;
+    void               compilePatterns();
+    [[nodiscard]] auto str(StrRef ref) const -> std::string_view;
+    [[nodiscard]] auto find(std::span<const Slot> table, std::string_view key) const -> const Slot*;
+
+    std::unique_ptr<utils::io::MappedFile> file_;
+    const Header*                          header_;
+    std::span<const Slot>                  players_; // player uuid → token groups
+    std::span<const Slot>                  acls_;    // node → ACEs
+    std::span<const StrRef>                groups_;
+    std::span<const AceRecord>             aces_;
+    std::string_view                       strings_;
+    NodePatternMatcher                     patterns_;
+    std::vector<std::uint32_t>             patternSlots_; // by pattern id, index into acls_
+};
+
+} // namespace BakaPerms::core
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -8,6 +9,18 @@
 
 namespace BakaPerms::core {
 
+/// Transparent hash so string-keyed maps can be probed with std::string_view without allocating.
+struct StringHash {
+    using is_transparent = void;
+
+    [[nodiscard]] auto operator()(const std::string_view value) const noexcept -> std::size_t {
+        return std::hash<std::string_view>{}(value);
+    }
+};
+
+template <typename Value>
+using StringMap = std::unordered_map<std::string, Value, StringHash, std::equal_to<>>;
+
 enum class AccessMask : int {
     Deny  = 0,
     Allow = 1,
@@ -18,6 +31,21 @@ enum class SubjectKind : int {
     Group  = 1,
 };
 
+enum class AsyncDelivery : int {
+    WorkerThread = 0, // Invoke the callback on the background thread that resolved the check
+    ServerThread = 1, // Hop back to the server thread before invoking the callback
+};
+
+enum class TransferFormat : int {
+    JsonLines = 0, // One JSON object per line; human-readable and editable
+    Binary    = 1, // Compact length-prefixed records
+};
+
+enum class AuditFormat : int {
+    Csv       = 0, // Header row, then one row per subject and node
+    JsonLines = 1, // One JSON object per subject and node
+};
+
 enum class TokenEntryKind : int {
     Subject        = 0, // Primary identity (the player or group being checked)
     DirectGroup    = 1, // A group the player directly belongs to
@@ -38,10 +66,10 @@ class AccessToken {
         entries_.push_back({std::move(uuid), kind});
     }
 
-    [[nodiscard]] bool contains(const std::string_view uuid) const { return index_.contains(std::string(uuid)); }
+    [[nodiscard]] bool contains(const std::string_view uuid) const { return index_.contains(uuid); }
 
     [[nodiscard]] auto find(const std::string_view uuid) const -> const TokenEntry* {
-        const auto it = index_.find(std::string(uuid));
+        const auto it = index_.find(uuid);
         if (it == index_.end()) return nullptr;
         return &entries_[it->second];
     }
@@ -51,8 +79,8 @@ class AccessToken {
     [[nodiscard]] auto entries() const -> const std::vector<TokenEntry>& { return entries_; }
 
 private:
-    std::vector<TokenEntry>                      entries_;
-    std::unordered_map<std::string, std::size_t> index_;
+    std::vector<TokenEntry> entries_;
+    StringMap<std::size_t>  index_;
 };
 
 struct ACE {
@@ -70,6 +98,7 @@ struct GroupInfo {
 
 struct TraceStep {
     std::string      node;
+    bool             pattern{false}; // `node` is a wildcard pattern matching the requested node
     bool             aclFound{false};
     std::vector<ACE> acl;               // Full ACL at this node
     int              matchedAceIdx{-1}; // Index into acl vector, -1 = no match
@@ -91,4 +120,16 @@ struct NodeACE {
     ACE         ace;
 };
 
+struct TransferStats {
+    std::size_t groups{0};
+    std::size_t memberships{0};
+    std::size_t aces{0};
+};
+
+struct AuditStats {
+    std::size_t subjects{0};
+    std::size_t nodes{0};
+    std::size_t rows{0};
+};
+
 } // namespace BakaPerms::core
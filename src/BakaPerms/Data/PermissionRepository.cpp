@@ -1,22 +1,68 @@
 #include "BakaPerms/Data/PermissionRepository.hpp"
 
+#include "BakaPerms/Data/RowDecoders.hpp"
 #include "BakaPerms/Database/DbTypes.hpp"
 
 #include <algorithm>
+#include <array>
 #include <format>
+#include <limits>
 #include <stdexcept>
 #include <unordered_set>
+#include <utility>
 
 namespace BakaPerms::data {
 
-static auto toAccessMask(const int value) -> core::AccessMask {
-    if (value != static_cast<int>(core::AccessMask::Deny) && value != static_cast<int>(core::AccessMask::Allow)) {
-        throw std::out_of_range(std::format("Invalid access_mask value in database: {}", value));
-    }
-    return static_cast<core::AccessMask>(value);
+// order_index holds a sparse sort key rather than the position: ACE::orderIndex is the rank of the
+// row within its node. New keys are placed between their neighbours, so an edit writes one row; a
+// node is respaced kOrderGap apart only when two neighbouring keys are adjacent.
+constexpr std::int64_t kOrderGap = 1 << 20;
+
+// Full-table reads shared by the getAll*() calls and loadAll().
+constexpr std::string_view kAllGroupsSql = "SELECT uuid, name, parent_uuid FROM groups ORDER BY name";
+
+// Ordered by group name within each player, matching getPlayerGroups().
+constexpr std::string_view kAllMembershipsSql = "SELECT pg.player_uuid, pg.group_uuid "
+                                                "FROM player_groups pg JOIN groups g ON pg.group_uuid = g.uuid "
+                                                "ORDER BY pg.player_uuid, g.name";
+
+constexpr std::string_view kAllACLsSql = "SELECT node, ROW_NUMBER() OVER (PARTITION BY node ORDER BY order_index) - 1, "
+                                         "subject_uuid, subject_type, access_mask "
+                                         "FROM permissions ORDER BY node, order_index ASC";
+
+namespace {
+
+// Row callback for rows ordered by their first column: collects the other columns, decoded as T, per key.
+template <typename T>
+auto groupInto(std::unordered_map<std::string, std::vector<T>>& result)
+    -> std::function<void(const database::RowView&)> {
+    const std::string* key    = nullptr; // element pointers survive rehashing
+    std::vector<T>*    values = nullptr;
+    return [&result, key, values](const database::RowView& row) mutable {
+        if (!key || *key != row.getText(0)) {
+            const auto it = result.try_emplace(std::string(row.getText(0))).first;
+            key           = &it->first;
+            values        = &it->second;
+        }
+        values->push_back(database::RowDecoder<T>::decode(row, 1));
+    };
+}
+
+auto unixSeconds(const std::chrono::system_clock::time_point time) -> std::int64_t {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
 }
 
-PermissionRepository::PermissionRepository(database::IDatabase& db) : db_(db) {}
+} // namespace
+
+PermissionRepository::PermissionRepository(database::IDatabase& db, std::string origin)
+: db_(db),
+  origin_(std::move(origin)) {}
+
+auto PermissionRepository::withoutChangeLog() const -> PermissionRepository {
+    auto repo        = *this;
+    repo.logChanges_ = false;
+    return repo;
+}
 
 void PermissionRepository::initializeSchema() const {
     db_.exec(R"(
@@ -24,7 +70,7 @@ void PermissionRepository::initializeSchema() const {
             uuid         TEXT PRIMARY KEY,
             name         TEXT NOT NULL UNIQUE,
             parent_uuid  TEXT DEFAULT NULL,
-            created_at   TEXT NOT NULL DEFAULT (datetime('now')),
+            created_at   TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
             FOREIGN KEY (parent_uuid) REFERENCES groups(uuid) ON DELETE SET NULL
         )
     )");
@@ -33,7 +79,7 @@ void PermissionRepository::initializeSchema() const {
         CREATE TABLE IF NOT EXISTS player_groups (
             player_uuid  TEXT NOT NULL,
             group_uuid   TEXT NOT NULL,
-            added_at     TEXT NOT NULL DEFAULT (datetime('now')),
+            added_at     TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
             PRIMARY KEY (player_uuid, group_uuid),
             FOREIGN KEY (group_uuid) REFERENCES groups(uuid) ON DELETE CASCADE
         )
@@ -42,15 +88,35 @@ void PermissionRepository::initializeSchema() const {
     db_.exec(R"(
         CREATE TABLE IF NOT EXISTS permissions (
             node          TEXT NOT NULL,
-            order_index   INTEGER NOT NULL,
+            order_index   BIGINT NOT NULL, -- sparse sort key, see kOrderGap
             subject_uuid  TEXT NOT NULL,
             subject_type  INTEGER NOT NULL,
             access_mask   INTEGER NOT NULL,
-            created_at    TEXT NOT NULL DEFAULT (datetime('now')),
+            created_at    TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
             PRIMARY KEY (node, order_index)
         )
     )");
 
+    // Ids come from change_log_seq rather than an auto-increment column: its single row stays locked
+    // until the writing transaction commits, so ids are handed out in commit order on every backend.
+    db_.exec(R"(
+        CREATE TABLE IF NOT EXISTS change_log (
+            id          BIGINT PRIMARY KEY,
+            kind        INTEGER NOT NULL, -- ChangeKind
+            target      TEXT NOT NULL,
+            origin      TEXT NOT NULL,
+            created_at  BIGINT NOT NULL   -- unix seconds
+        )
+    )");
+
+    db_.exec(R"(
+        CREATE TABLE IF NOT EXISTS change_log_seq (
+            id       INTEGER PRIMARY KEY CHECK (id = 0),
+            last_id  BIGINT NOT NULL
+        )
+    )");
+    db_.exec("INSERT INTO change_log_seq (id, last_id) VALUES (0, 0) ON CONFLICT DO NOTHING");
+
     db_.exec("CREATE INDEX IF NOT EXISTS idx_permissions_node ON permissions(node)");
     db_.exec("CREATE INDEX IF NOT EXISTS idx_permissions_subject ON permissions(subject_uuid)");
     db_.exec("CREATE INDEX IF NOT EXISTS idx_player_groups_player ON player_groups(player_uuid)");
@@ -62,26 +128,18 @@ void PermissionRepository::createGroup(
     const std::string_view                 name,
     const std::optional<std::string_view>& parentUuid
 ) const {
-    database::ParamList params = {std::string(uuid), std::string(name)};
-    if (parentUuid) {
-        params.emplace_back(std::string(*parentUuid));
-    } else {
-        params.emplace_back(database::DbNull{});
-    }
-    db_.execute("INSERT INTO groups (uuid, name, parent_uuid) VALUES (?, ?, ?)", params);
+    db_.withTransaction([&] {
+        db_.execute("INSERT INTO groups (uuid, name, parent_uuid) VALUES (?, ?, ?)", uuid, name, parentUuid);
+        logChange(ChangeKind::Group, uuid);
+    });
 }
 
 void PermissionRepository::deleteGroup(const std::string_view uuid) const {
+    // Removed ACEs leave gaps between sort keys; positions of the remaining ACEs close up by themselves.
     db_.withTransaction([&] {
-        // Collect affected nodes before deletion so we can reindex them
-        const auto affectedRows =
-            db_.query("SELECT DISTINCT node FROM permissions WHERE subject_uuid = ?", {std::string(uuid)});
-        db_.execute("DELETE FROM permissions WHERE subject_uuid = ?", {std::string(uuid)});
-        db_.execute("DELETE FROM groups WHERE uuid = ?", {std::string(uuid)});
-        // Reindex affected nodes to close gaps in order_index
-        for (const auto& row : affectedRows) {
-            reindexACL(row.getString(0));
-        }
+        db_.execute("DELETE FROM permissions WHERE subject_uuid = ?", uuid);
+        db_.execute("DELETE FROM groups WHERE uuid = ?", uuid);
+        logChange(ChangeKind::GroupDeleted, uuid);
     });
 }
 
@@ -89,94 +147,72 @@ void PermissionRepository::setGroupParent(
     const std::string_view                 uuid,
     const std::optional<std::string_view>& parentUuid
 ) const {
-    database::ParamList params;
-    if (parentUuid) {
-        params.emplace_back(std::string(*parentUuid));
-    } else {
-        params.emplace_back(database::DbNull{});
-    }
-    params.emplace_back(std::string(uuid));
-    db_.execute("UPDATE groups SET parent_uuid = ? WHERE uuid = ?", params);
-}
-
-static auto rowToGroupInfo(const database::Row& row) -> core::GroupInfo {
-    core::GroupInfo info;
-    info.uuid       = row.getString(0);
-    info.name       = row.getString(1);
-    info.parentUuid = row.isNull(2) ? std::nullopt : std::optional(row.getString(2));
-    return info;
+    db_.withTransaction([&] {
+        db_.execute("UPDATE groups SET parent_uuid = ? WHERE uuid = ?", parentUuid, uuid);
+        logChange(ChangeKind::Group, uuid);
+    });
 }
 
 auto PermissionRepository::getGroup(const std::string_view uuid) const -> std::optional<core::GroupInfo> {
-    const auto row = db_.queryOne("SELECT uuid, name, parent_uuid FROM groups WHERE uuid = ?", {std::string(uuid)});
-    if (!row) return std::nullopt;
-    return rowToGroupInfo(*row);
+    return db_.queryOneAs<core::GroupInfo>("SELECT uuid, name, parent_uuid FROM groups WHERE uuid = ?", uuid);
 }
 
 auto PermissionRepository::getGroupByName(const std::string_view name) const -> std::optional<core::GroupInfo> {
-    const auto row = db_.queryOne("SELECT uuid, name, parent_uuid FROM groups WHERE name = ?", {std::string(name)});
-    if (!row) return std::nullopt;
-    return rowToGroupInfo(*row);
+    return db_.queryOneAs<core::GroupInfo>("SELECT uuid, name, parent_uuid FROM groups WHERE name = ?", name);
 }
 
 auto PermissionRepository::getAllGroups() const -> std::vector<core::GroupInfo> {
-    const auto                   rows = db_.query("SELECT uuid, name, parent_uuid FROM groups ORDER BY name");
-    std::vector<core::GroupInfo> result;
-    result.reserve(rows.size());
-    for (const auto& row : rows) {
-        result.push_back(rowToGroupInfo(row));
-    }
-    return result;
+    return db_.queryAs<core::GroupInfo>(kAllGroupsSql);
 }
 
 // Membership
 bool PermissionRepository::addPlayerToGroup(const std::string_view playerUuid, const std::string_view groupUuid) const {
-    return db_.execute(
-               "INSERT OR IGNORE INTO player_groups (player_uuid, group_uuid) VALUES (?, ?)",
-               {std::string(playerUuid), std::string(groupUuid)}
-           )
-         > 0;
+    bool added = false;
+    db_.withTransaction([&] {
+        added = db_.execute(
+                    "INSERT INTO player_groups (player_uuid, group_uuid) VALUES (?, ?) ON CONFLICT DO NOTHING",
+                    playerUuid,
+                    groupUuid
+                )
+              > 0;
+        if (added) logChange(ChangeKind::Membership, playerUuid);
+    });
+    return added;
 }
 
 bool PermissionRepository::removePlayerFromGroup(
     const std::string_view playerUuid,
     const std::string_view groupUuid
 ) const {
-    return db_.execute(
-               "DELETE FROM player_groups WHERE player_uuid = ? AND group_uuid = ?",
-               {std::string(playerUuid), std::string(groupUuid)}
-           )
-         > 0;
+    bool removed = false;
+    db_.withTransaction([&] {
+        removed = db_.execute(
+                      "DELETE FROM player_groups WHERE player_uuid = ? AND group_uuid = ?",
+                      playerUuid,
+                      groupUuid
+                  )
+                > 0;
+        if (removed) logChange(ChangeKind::Membership, playerUuid);
+    });
+    return removed;
 }
 
 auto PermissionRepository::getPlayerGroups(const std::string_view playerUuid) const -> std::vector<core::GroupInfo> {
-    const auto rows = db_.query(
+    return db_.queryAs<core::GroupInfo>(
         "SELECT g.uuid, g.name, g.parent_uuid "
         "FROM player_groups pg JOIN groups g ON pg.group_uuid = g.uuid "
         "WHERE pg.player_uuid = ? ORDER BY g.name",
-        {std::string(playerUuid)}
+        playerUuid
     );
-    std::vector<core::GroupInfo> result;
-    result.reserve(rows.size());
-    for (const auto& row : rows) {
-        result.push_back(rowToGroupInfo(row));
-    }
-    return result;
 }
 
 auto PermissionRepository::getGroupMembers(const std::string_view groupUuid) const -> std::vector<std::string> {
-    const auto rows = db_.query("SELECT player_uuid FROM player_groups WHERE group_uuid = ?", {std::string(groupUuid)});
-    std::vector<std::string> result;
-    result.reserve(rows.size());
-    for (const auto& row : rows) {
-        result.push_back(row.getString(0));
-    }
-    return result;
+    return db_.queryAs<std::string>("SELECT player_uuid FROM player_groups WHERE group_uuid = ?", groupUuid);
 }
 
 // Ancestry
 auto PermissionRepository::getGroupAncestry(const std::string_view groupUuid) const -> std::vector<core::GroupInfo> {
-    const auto rows = db_.query(
+    auto groups = db_.queryAs<core::GroupInfo>(
         R"(
             WITH RECURSIVE ancestry(uuid, name, parent_uuid, depth) AS (
                 SELECT uuid, name, parent_uuid, 0
@@ -189,13 +225,12 @@ auto PermissionRepository::getGroupAncestry(const std::string_view groupUuid) co
             )
             SELECT uuid, name, parent_uuid FROM ancestry ORDER BY depth
         )",
-        {std::string(groupUuid)}
+        groupUuid
     );
 
     std::vector<core::GroupInfo>    chain;
     std::unordered_set<std::string> visited;
-    for (const auto& row : rows) {
-        auto info = rowToGroupInfo(row);
+    for (auto& info : groups) {
         if (visited.contains(info.uuid)) break; // cycle detection
         visited.insert(info.uuid);
         chain.push_back(std::move(info));
@@ -204,14 +239,6 @@ auto PermissionRepository::getGroupAncestry(const std::string_view groupUuid) co
 }
 
 // ACL operations
-static auto rowToACE(const database::Row& row) -> core::ACE {
-    return {
-        .orderIndex  = row.getInt(0),
-        .subjectUuid = row.getString(1),
-        .subjectType = row.getInt(2),
-        .mask        = toAccessMask(row.getInt(3)),
-    };
-}
 
 void PermissionRepository::appendACE(
     const std::string_view node,
@@ -220,16 +247,18 @@ void PermissionRepository::appendACE(
     core::AccessMask       mask
 ) const {
     db_.withTransaction([&] {
-        const auto row = db_.queryOne(
-            "SELECT COALESCE(MAX(order_index), -1) + 1 FROM permissions WHERE node = ?",
-            {std::string(node)}
-        );
-        int nextIndex = row ? row->getInt(0) : 0;
+        const auto row = db_.queryOne("SELECT MAX(order_index) FROM permissions WHERE node = ?", node);
+        const auto key = row && !row->isNull(0) ? row->getInt64(0) + kOrderGap : 0;
         db_.execute(
             "INSERT INTO permissions (node, order_index, subject_uuid, subject_type, access_mask) VALUES (?, ?, ?, ?, "
             "?)",
-            {std::string(node), nextIndex, std::string(subjectUuid), subjectType, static_cast<int>(mask)}
+            node,
+            key,
+            subjectUuid,
+            subjectType,
+            static_cast<int>(mask)
         );
+        logChange(ChangeKind::Node, node);
     });
 }
 
@@ -241,47 +270,45 @@ void PermissionRepository::insertACE(
     core::AccessMask       mask
 ) const {
     db_.withTransaction([&] {
-        // Validate position bounds
-        const auto countRow = db_.queryOne("SELECT COUNT(*) FROM permissions WHERE node = ?", {std::string(node)});
-        if (const int count = countRow ? countRow->getInt(0) : 0; position < 0 || position > count) {
-            throw std::out_of_range(std::format("ACE position {} is out of range [0, {}]", position, count));
+        // Validate position bounds: the ACE before the new one must exist
+        if (position < 0 || (position > 0 && !sortKeyAt(node, position - 1))) {
+            throw std::out_of_range(std::format("ACE position {} is out of range [0, {}]", position, aclSize(node)));
+        }
+        auto key = sortKeyBetween(node, position, std::nullopt);
+        if (!key) {
+            renumberACL(node);
+            key = sortKeyBetween(node, position, std::nullopt);
         }
-        // Shift existing ACEs using negative offset to avoid PRIMARY KEY conflicts.
-        // -(order_index + 1) produces unique negative values; then -order_index restores them shifted +1.
-        db_.execute(
-            "UPDATE permissions SET order_index = -(order_index + 1) WHERE node = ? AND order_index >= ?",
-            {std::string(node), position}
-        );
-        db_.execute(
-            "UPDATE permissions SET order_index = -order_index WHERE node = ? AND order_index < 0",
-            {std::string(node)}
-        );
-        // Insert new ACE at position
         db_.execute(
             "INSERT INTO permissions (node, order_index, subject_uuid, subject_type, access_mask) VALUES (?, ?, ?, ?, "
             "?)",
-            {std::string(node), position, std::string(subjectUuid), subjectType, static_cast<int>(mask)}
+            node,
+            *key,
+            subjectUuid,
+            subjectType,
+            static_cast<int>(mask)
         );
+        logChange(ChangeKind::Node, node);
     });
 }
 
 void PermissionRepository::removeACE(std::string_view node, int orderIndex) const {
+    // A single delete: the ACEs after it move up one position without being rewritten.
     db_.withTransaction([&] {
-        const int affected =
-            db_.execute("DELETE FROM permissions WHERE node = ? AND order_index = ?", {std::string(node), orderIndex});
+        int affected = 0;
+        if (orderIndex >= 0) {
+            affected = db_.execute(
+                "DELETE FROM permissions WHERE node = ? AND order_index = "
+                "(SELECT order_index FROM permissions WHERE node = ? ORDER BY order_index LIMIT 1 OFFSET ?)",
+                node,
+                node,
+                orderIndex
+            );
+        }
         if (affected == 0) {
             throw std::out_of_range(std::format("No ACE found at position {} on node '{}'", orderIndex, node));
         }
-        // Shift entries after the removed one down by 1.
-        // Use negative offset to avoid PRIMARY KEY conflicts regardless of row processing order.
-        db_.execute(
-            "UPDATE permissions SET order_index = -order_index WHERE node = ? AND order_index > ?",
-            {std::string(node), orderIndex}
-        );
-        db_.execute(
-            "UPDATE permissions SET order_index = (-order_index) - 1 WHERE node = ? AND order_index < 0",
-            {std::string(node)}
-        );
+        logChange(ChangeKind::Node, node);
     });
 }
 
@@ -289,77 +316,121 @@ void PermissionRepository::moveACE(const std::string_view node, const int fromIn
     if (fromIndex == toIndex) return;
 
     db_.withTransaction([&] {
-        auto acl = getNodeACL(node);
-        if (fromIndex < 0 || fromIndex >= static_cast<int>(acl.size()) || toIndex < 0
-            || toIndex >= static_cast<int>(acl.size())) {
-            throw std::out_of_range(
-                std::format("ACE move position out of range: from={}, to={}, size={}", fromIndex, toIndex, acl.size())
-            );
+        auto fromKey = fromIndex >= 0 ? sortKeyAt(node, fromIndex) : std::nullopt;
+        if (!fromKey || toIndex < 0 || !sortKeyAt(node, toIndex)) {
+            throw std::out_of_range(std::format(
+                "ACE move position out of range: from={}, to={}, size={}",
+                fromIndex,
+                toIndex,
+                aclSize(node)
+            ));
         }
 
-        const auto ace = acl[static_cast<size_t>(fromIndex)];
-        acl.erase(acl.begin() + fromIndex);
-        acl.insert(acl.begin() + toIndex, ace);
-
-        writeACL(node, acl);
+        // Only the moved row is rewritten; the rows it passes keep their keys and shift position implicitly.
+        auto key = sortKeyBetween(node, toIndex, fromKey);
+        if (!key) {
+            renumberACL(node);
+            fromKey = sortKeyAt(node, fromIndex);
+            key     = sortKeyBetween(node, toIndex, fromKey);
+        }
+        db_.execute("UPDATE permissions SET order_index = ? WHERE node = ? AND order_index = ?", *key, node, *fromKey);
+        logChange(ChangeKind::Node, node);
     });
 }
 
 auto PermissionRepository::getNodeACL(const std::string_view node) const -> std::vector<core::ACE> {
-    const auto rows = db_.query(
-        "SELECT order_index, subject_uuid, subject_type, access_mask "
+    return db_.queryAs<core::ACE>(
+        "SELECT ROW_NUMBER() OVER (ORDER BY order_index) - 1, subject_uuid, subject_type, access_mask "
         "FROM permissions WHERE node = ? ORDER BY order_index ASC",
-        {std::string(node)}
+        node
     );
-    std::vector<core::ACE> result;
-    result.reserve(rows.size());
-    for (const auto& row : rows) {
-        result.push_back(rowToACE(row));
-    }
-    return result;
 }
 
 void PermissionRepository::clearNodeACL(const std::string_view node) const {
-    db_.execute("DELETE FROM permissions WHERE node = ?", {std::string(node)});
+    db_.withTransaction([&] {
+        db_.execute("DELETE FROM permissions WHERE node = ?", node);
+        logChange(ChangeKind::Node, node);
+    });
 }
 
 auto PermissionRepository::getSubjectACEs(const std::string_view subjectUuid) const -> std::vector<core::NodeACE> {
-    const auto rows = db_.query(
-        "SELECT node, order_index, subject_uuid, subject_type, access_mask "
-        "FROM permissions WHERE subject_uuid = ? ORDER BY node, order_index",
-        {std::string(subjectUuid)}
+    return db_.queryAs<core::NodeACE>(
+        "SELECT p.node, "
+        "(SELECT COUNT(*) FROM permissions q WHERE q.node = p.node AND q.order_index < p.order_index), "
+        "p.subject_uuid, p.subject_type, p.access_mask "
+        "FROM permissions p WHERE p.subject_uuid = ? ORDER BY p.node, p.order_index",
+        subjectUuid
     );
-    std::vector<core::NodeACE> result;
-    result.reserve(rows.size());
-    for (const auto& row : rows) {
-        result.push_back({
-            .node = row.getString(0),
-            .ace  = {
-                     .orderIndex  = row.getInt(1),
-                     .subjectUuid = row.getString(2),
-                     .subjectType = row.getInt(3),
-                     .mask        = toAccessMask(row.getInt(4)),
-                     },
-        });
-    }
-    return result;
 }
 
-void PermissionRepository::reindexACL(const std::string_view node) const {
-    const auto acl = getNodeACL(node);
-    writeACL(node, acl);
+auto PermissionRepository::sortKeyAt(const std::string_view node, const int position) const
+    -> std::optional<std::int64_t> {
+    return db_.queryOneAs<std::int64_t>(
+        "SELECT order_index FROM permissions WHERE node = ? ORDER BY order_index LIMIT 1 OFFSET ?",
+        node,
+        position
+    );
+}
+
+auto PermissionRepository::aclSize(const std::string_view node) const -> int {
+    return db_.queryOneAs<int>("SELECT COUNT(*) FROM permissions WHERE node = ?", node).value_or(0);
+}
+
+auto PermissionRepository::sortKeyBetween(
+    const std::string_view             node,
+    const int                          position,
+    const std::optional<std::int64_t>& exclude
+) const -> std::optional<std::int64_t> {
+    // Neighbours are the rows at position - 1 and position once `exclude` is taken out.
+    const auto                limit  = position > 0 ? 2 : 1;
+    const auto                offset = std::max(position - 1, 0);
+    std::vector<std::int64_t> keys;
+    if (exclude) {
+        keys = db_.queryAs<std::int64_t>(
+            "SELECT order_index FROM permissions WHERE node = ? AND order_index <> ? "
+            "ORDER BY order_index LIMIT ? OFFSET ?",
+            node,
+            *exclude,
+            limit,
+            offset
+        );
+    } else {
+        keys = db_.queryAs<std::int64_t>(
+            "SELECT order_index FROM permissions WHERE node = ? ORDER BY order_index LIMIT ? OFFSET ?",
+            node,
+            limit,
+            offset
+        );
+    }
+
+    std::optional<std::int64_t> before;
+    std::optional<std::int64_t> after;
+    if (position > 0 && !keys.empty()) before = keys.front();
+    if (keys.size() > (position > 0 ? 1u : 0u)) after = keys.back();
+
+    if (!before && !after) return 0;
+    if (!after) return *before + kOrderGap;
+    if (!before) return *after - kOrderGap;
+    if (*after - *before < 2) return std::nullopt;
+    return *before + (*after - *before) / 2;
 }
 
-void PermissionRepository::writeACL(const std::string_view node, const std::vector<core::ACE>& acl) const {
-    // Move all to negative temporary indices to avoid PRIMARY KEY conflicts during reorder.
-    // -(order_index + 1) maps 0→-1, 1→-2, etc. — all unique and negative.
-    db_.execute("UPDATE permissions SET order_index = -(order_index + 1) WHERE node = ?", {std::string(node)});
-    // Update each ACE to its new position, matching by its original (now negated) order_index.
-    // This preserves created_at and other columns.
-    for (int i = 0; i < static_cast<int>(acl.size()); ++i) {
+void PermissionRepository::renumberACL(const std::string_view node) const {
+    const auto keys =
+        db_.queryAs<std::int64_t>("SELECT order_index FROM permissions WHERE node = ? ORDER BY order_index", node);
+    if (keys.empty()) return;
+
+    // First move every key above both the old and the new range, so no single update collides with the
+    // primary key, then respace them kOrderGap apart in order.
+    const auto count = static_cast<std::int64_t>(keys.size());
+    const auto shift = std::max(keys.back(), (count - 1) * kOrderGap) + 1 - keys.front();
+    db_.execute("UPDATE permissions SET order_index = order_index + ? WHERE node = ?", shift, node);
+    for (std::int64_t i = 0; i < count; ++i) {
         db_.execute(
             "UPDATE permissions SET order_index = ? WHERE node = ? AND order_index = ?",
-            {i, std::string(node), -(acl[static_cast<size_t>(i)].orderIndex + 1)}
+            i * kOrderGap,
+            node,
+            keys[static_cast<std::size_t>(i)] + shift
         );
     }
 }
@@ -368,27 +439,224 @@ auto PermissionRepository::getNodeACLBatch(const std::vector<std::string>& nodes
     -> std::unordered_map<std::string, std::vector<core::ACE>> {
     if (nodes.empty()) return {};
 
-    // Build parameterized IN clause
-    std::string         sql = "SELECT node, order_index, subject_uuid, subject_type, access_mask "
-                              "FROM permissions WHERE node IN (";
-    database::ParamList params;
+    // Build parameterized IN clause; the nodes are bound as views, not copied
+    constexpr std::string_view kHead = "SELECT node, ROW_NUMBER() OVER (PARTITION BY node ORDER BY order_index) - 1, "
+                                       "subject_uuid, subject_type, access_mask FROM permissions WHERE node IN (";
+    constexpr std::string_view kTail = ") ORDER BY node, order_index ASC";
+    std::string                sql;
+    sql.reserve(kHead.size() + nodes.size() * 3 + kTail.size());
+    sql += kHead;
+    std::vector<database::DbParam> params;
+    params.reserve(nodes.size());
     for (std::size_t i = 0; i < nodes.size(); ++i) {
-        if (i > 0) sql += ", ";
-        sql += "?";
-        params.emplace_back(nodes[i]);
+        sql += i > 0 ? ", ?" : "?";
+        params.emplace_back(std::string_view(nodes[i]));
     }
-    sql += ") ORDER BY node, order_index ASC";
-
-    const auto                                              rows = db_.query(sql, params);
-    std::unordered_map<std::string, std::vector<core::ACE>> result;
-    for (const auto& row : rows) {
-        result[row.getString(0)].push_back({
-            .orderIndex  = row.getInt(1),
-            .subjectUuid = row.getString(2),
-            .subjectType = row.getInt(3),
-            .mask        = toAccessMask(row.getInt(4)),
-        });
+    sql += kTail;
+
+    return groupRows<core::ACE>(sql, params);
+}
+
+void PermissionRepository::forEachGroup(const std::function<void(const core::GroupInfo&)>& fn, const int pageSize)
+    const {
+    // The bound cursor is a view, so each page collects the next one separately.
+    std::string after;
+    std::string last;
+    for (int rows = pageSize; rows == pageSize;) {
+        rows = 0;
+        db_.forEachRow(
+            "SELECT uuid, name, parent_uuid FROM groups WHERE uuid > ? ORDER BY uuid LIMIT ?",
+            [&](const database::RowView& row) {
+                auto group = database::RowDecoder<core::GroupInfo>::decode(row, 0);
+                fn(group);
+                last = std::move(group.uuid);
+                ++rows;
+            },
+            after,
+            pageSize
+        );
+        after.swap(last);
     }
+}
+
+void PermissionRepository::forEachMembership(
+    const std::function<void(const std::string& playerUuid, const std::string& groupUuid)>& fn,
+    const int                                                                               pageSize
+) const {
+    std::string afterPlayer;
+    std::string afterGroup;
+    std::string lastPlayer;
+    std::string lastGroup;
+    for (int rows = pageSize; rows == pageSize;) {
+        rows = 0;
+        db_.forEachRow(
+            "SELECT player_uuid, group_uuid FROM player_groups WHERE (player_uuid, group_uuid) > (?, ?) "
+            "ORDER BY player_uuid, group_uuid LIMIT ?",
+            [&](const database::RowView& row) {
+                lastPlayer = row.getText(0);
+                lastGroup  = row.getText(1);
+                fn(lastPlayer, lastGroup);
+                ++rows;
+            },
+            afterPlayer,
+            afterGroup,
+            pageSize
+        );
+        afterPlayer.swap(lastPlayer);
+        afterGroup.swap(lastGroup);
+    }
+}
+
+void PermissionRepository::forEachACE(
+    const std::function<void(const std::string& node, const core::ACE& ace)>& fn,
+    const int                                                                 pageSize
+) const {
+    std::string  afterNode;
+    std::string  node;
+    std::int64_t afterKey = std::numeric_limits<std::int64_t>::min();
+    int          position = 0;
+    for (int rows = pageSize; rows == pageSize;) {
+        rows = 0;
+        // Positions are counted here rather than with ROW_NUMBER(), which would restart at every page.
+        db_.forEachRow(
+            // The BIGINT sort key is read on its own; the ACE is decoded from a placeholder position
+            // column, since the key does not fit the ACE's int position.
+            "SELECT node, order_index, 0, subject_uuid, subject_type, access_mask FROM permissions "
+            "WHERE (node, order_index) > (?, ?) ORDER BY node, order_index LIMIT ?",
+            [&](const database::RowView& row) {
+                if (row.getText(0) != node) {
+                    node     = row.getText(0);
+                    position = 0;
+                }
+                afterKey       = row.getInt64(1); // bound by value, so it may change while stepping
+                auto ace       = database::RowDecoder<core::ACE>::decode(row, 2);
+                ace.orderIndex = position++;
+                fn(node, ace);
+                ++rows;
+            },
+            afterNode,
+            afterKey,
+            pageSize
+        );
+        afterNode = node;
+    }
+}
+
+void PermissionRepository::upsertGroup(const std::string_view uuid, const std::string_view name) const {
+    db_.withTransaction([&] {
+        db_.execute(
+            "INSERT INTO groups (uuid, name) VALUES (?, ?) ON CONFLICT (uuid) DO UPDATE SET name = excluded.name",
+            uuid,
+            name
+        );
+        logChange(ChangeKind::Group, uuid);
+    });
+}
+
+void PermissionRepository::putACE(
+    const std::string_view node,
+    const int              position,
+    const std::string_view subjectUuid,
+    const int              subjectType,
+    const core::AccessMask mask
+) const {
+    db_.withTransaction([&] {
+        db_.execute(
+            "INSERT INTO permissions (node, order_index, subject_uuid, subject_type, access_mask) "
+            "VALUES (?, ?, ?, ?, ?)",
+            node,
+            position * kOrderGap,
+            subjectUuid,
+            subjectType,
+            static_cast<int>(mask)
+        );
+        logChange(ChangeKind::Node, node);
+    });
+}
+
+auto PermissionRepository::getAllMemberships() const -> std::unordered_map<std::string, std::vector<std::string>> {
+    return groupRows<std::string>(kAllMembershipsSql);
+}
+
+auto PermissionRepository::getAllACLs() const -> std::unordered_map<std::string, std::vector<core::ACE>> {
+    return groupRows<core::ACE>(kAllACLsSql);
+}
+
+auto PermissionRepository::loadAll() const -> FullState {
+    FullState  state;
+    const auto decodeGroup = [&state](const database::RowView& row) {
+        state.groups.push_back(database::RowDecoder<core::GroupInfo>::decode(row, 0));
+    };
+    const std::array<database::BatchQuery, 3> batch = {{
+        {kAllGroupsSql,      {}, decodeGroup                 },
+        {kAllMembershipsSql, {}, groupInto(state.memberships)},
+        {kAllACLsSql,        {}, groupInto(state.acls)       },
+    }};
+    db_.forEachRowBatch(batch);
+    return state;
+}
+
+// Change log
+auto PermissionRepository::latestChangeId() const -> std::int64_t {
+    return db_.queryOneAs<std::int64_t>("SELECT last_id FROM change_log_seq").value_or(0);
+}
+
+auto PermissionRepository::getChangesSince(const std::int64_t afterId, const int limit) const -> ChangeFeed {
+    ChangeFeed                                feed;
+    std::optional<std::int64_t>               oldest;
+    const database::DbParam                   params[] = {afterId, std::string_view(origin_), limit};
+    const std::array<database::BatchQuery, 3> batch    = {{
+        {"SELECT last_id FROM change_log_seq",
+         {},
+         [&feed](const database::RowView& row) { feed.latestId = row.getInt64(0); }},
+        {"SELECT MIN(id) FROM change_log",
+         {},
+         [&oldest](const database::RowView& row) {
+             if (!row.isNull(0)) oldest = row.getInt64(0);
+         }},
+        {"SELECT id, kind, target FROM change_log WHERE id > ? AND origin <> ? ORDER BY id LIMIT ?",
+         params,
+         [&feed](const database::RowView& row) {
+             feed.entries.push_back(
+                 {row.getInt64(0), static_cast<ChangeKind>(row.getInt(1)), std::string(row.getText(2))}
+             );
+         }},
+    }};
+    db_.forEachRowBatch(batch);
+    feed.oldestId = oldest.value_or(feed.latestId + 1);
+    return feed;
+}
+
+auto PermissionRepository::trimChangeLog(const std::chrono::system_clock::time_point cutoff) const -> int {
+    // Always a prefix of the ids, even if servers' clocks disagree, so gaps stay detectable.
+    return db_.execute(
+        "DELETE FROM change_log WHERE id <= (SELECT MAX(id) FROM change_log WHERE created_at < ?)",
+        unixSeconds(cutoff)
+    );
+}
+
+void PermissionRepository::logReload() const {
+    db_.withTransaction([&] { logChange(ChangeKind::Reload, ""); });
+}
+
+void PermissionRepository::logChange(const ChangeKind kind, const std::string_view target) const {
+    if (!logChanges_) return;
+    db_.execute("UPDATE change_log_seq SET last_id = last_id + 1");
+    db_.execute(
+        "INSERT INTO change_log (id, kind, target, origin, created_at) "
+        "SELECT last_id, ?, ?, ?, ? FROM change_log_seq",
+        static_cast<int>(kind),
+        target,
+        origin_,
+        unixSeconds(std::chrono::system_clock::now())
+    );
+}
+
+template <typename T>
+auto PermissionRepository::groupRows(const std::string_view sql, const database::ParamSpan params) const
+    -> std::unordered_map<std::string, std::vector<T>> {
+    std::unordered_map<std::string, std::vector<T>> result;
+    db_.forEachRow(sql, params, groupInto(result));
     return result;
 }
 
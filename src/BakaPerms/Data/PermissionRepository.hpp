@@ -2,6 +2,9 @@
 #include "BakaPerms/Core/Types.hpp"
 #include "BakaPerms/Database/IDatabase.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -10,9 +13,35 @@
 
 namespace BakaPerms::data {
 
+/// What a change-log entry touched; `target` is the key of the part of the snapshot to re-read.
+enum class ChangeKind : int {
+    Group        = 1, // target: group uuid
+    GroupDeleted = 2, // target: group uuid; its memberships and ACEs went with it
+    Membership   = 3, // target: player uuid
+    Node         = 4, // target: node
+    Reload       = 5, // target: empty; rows were written without entries of their own, re-read everything
+};
+
+struct ChangeEntry {
+    std::int64_t id;
+    ChangeKind   kind;
+    std::string  target;
+};
+
+struct ChangeFeed {
+    std::int64_t             latestId{0}; // highest id handed out
+    std::int64_t             oldestId{0}; // lowest id not yet trimmed; latestId + 1 if the log is empty
+    std::vector<ChangeEntry> entries;     // ordered by id
+};
+
 class PermissionRepository {
 public:
-    explicit PermissionRepository(database::IDatabase& db);
+    /// Every mutation appends a change-log entry tagged with `origin`, in the same transaction.
+    explicit PermissionRepository(database::IDatabase& db, std::string origin = {});
+
+    /// A repository on the same database whose mutations append no change-log entries, for bulk writes
+    /// that end with a single logReload() instead.
+    [[nodiscard]] auto withoutChangeLog() const -> PermissionRepository;
 
     void initializeSchema() const;
 
@@ -55,11 +84,68 @@ class PermissionRepository {
     [[nodiscard]] auto getNodeACLBatch(const std::vector<std::string>& nodes) const
         -> std::unordered_map<std::string, std::vector<core::ACE>>;
 
+    // Bulk transfer: full-table scans paged by primary key, so memory stays bounded by `pageSize` rows.
+    // `fn` runs while a page is being read and must not use the repository.
+    void forEachGroup(const std::function<void(const core::GroupInfo&)>& fn, int pageSize = 1000) const;
+    void forEachMembership(
+        const std::function<void(const std::string& playerUuid, const std::string& groupUuid)>& fn,
+        int                                                                                     pageSize = 1000
+    ) const;
+    void forEachACE(const std::function<void(const std::string& node, const core::ACE& ace)>& fn, int pageSize = 1000)
+        const;
+    void upsertGroup(std::string_view uuid, std::string_view name) const; // keeps parent_uuid of an existing row
+    void putACE(
+        std::string_view node,
+        int              position,
+        std::string_view subjectUuid,
+        int              subjectType,
+        core::AccessMask mask
+    ) const; // raw insert at an explicit position of a cleared node, no neighbour lookup
+
+    // Full-table loads for the in-memory snapshot
+    [[nodiscard]] auto getAllMemberships() const -> std::unordered_map<std::string, std::vector<std::string>>;
+    [[nodiscard]] auto getAllACLs() const -> std::unordered_map<std::string, std::vector<core::ACE>>;
+
+    struct FullState {
+        std::vector<core::GroupInfo>                              groups; // by name
+        std::unordered_map<std::string, std::vector<std::string>> memberships;
+        std::unordered_map<std::string, std::vector<core::ACE>>   acls;
+    };
+    // getAllGroups(), getAllMemberships() and getAllACLs() as one batch: the three tables are read
+    // from the same state of the database, in a single round trip on network backends.
+    [[nodiscard]] auto loadAll() const -> FullState;
+
+    // Change log. Ids are consecutive, become visible in commit order and are trimmed oldest first,
+    // so a reader whose last id is below oldestId - 1 knows it missed entries.
+    [[nodiscard]] auto latestChangeId() const -> std::int64_t;
+    // Up to `limit` entries above `afterId` made through other repositories, i.e. with another origin,
+    // read in one batch with the id bounds.
+    [[nodiscard]] auto getChangesSince(std::int64_t afterId, int limit) const -> ChangeFeed;
+    // Deletes the entries up to the newest one created before `cutoff`; returns how many.
+    auto trimChangeLog(std::chrono::system_clock::time_point cutoff) const -> int;
+    // Appends a ChangeKind::Reload entry in its own transaction.
+    void logReload() const;
+
 private:
-    void reindexACL(std::string_view node) const;
-    void writeACL(std::string_view node, const std::vector<core::ACE>& acl) const;
+    // Sort keys (see kOrderGap in the .cpp). Positions are ranks by key within the node.
+    [[nodiscard]] auto sortKeyAt(std::string_view node, int position) const -> std::optional<std::int64_t>;
+    [[nodiscard]] auto aclSize(std::string_view node) const -> int;
+    // Key for a row placed at `position`, ignoring the row keyed `exclude`; nullopt if its neighbours are adjacent.
+    [[nodiscard]] auto
+    sortKeyBetween(std::string_view node, int position, const std::optional<std::int64_t>& exclude) const
+        -> std::optional<std::int64_t>;
+    void renumberACL(std::string_view node) const;
+    // Must run inside the transaction making the change.
+    void logChange(ChangeKind kind, std::string_view target) const;
+
+    // Rows ordered by their first column, collected per key; the other columns are decoded as T.
+    template <typename T>
+    auto groupRows(std::string_view sql, database::ParamSpan params = {}) const
+        -> std::unordered_map<std::string, std::vector<T>>;
 
     database::IDatabase& db_;
+    std::string          origin_;
+    bool                 logChanges_{true};
 };
 
 } // namespace BakaPerms::data
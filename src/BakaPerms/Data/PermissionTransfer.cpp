@@ -0,0 +1,375 @@
+#include "BakaPerms/Data/PermissionTransfer.hpp"
+
+#include "BakaPerms/Utils/IO/BinaryStream.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <format>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <variant>
+
+namespace BakaPerms::data {
+
+namespace {
+
+struct MembershipRecord {
+    std::string playerUuid;
+    std::string groupUuid;
+};
+
+using Record = std::variant<core::GroupInfo, MembershipRecord, core::NodeACE>;
+
+constexpr int kFormatVersion = 1;
+
+// JSON Lines: a header object, then one object per record.
+//   {"type":"bakaperms","version":1}
+//   {"type":"group","uuid":"…","name":"admin","parent":null}
+//   {"type":"member","player":"…","group":"…"}
+//   {"type":"ace","node":"a.b","subject":"…","subjectType":"group","access":"allow"}
+//
+// Binary: magic "BPEX", u32 version, then tagged records and a terminating tag 0 so truncation is detected.
+//   1 group   str uuid, str name, u8 hasParent, [str parent]
+//   2 member  str player, str group
+//   3 ace     str node, str subject, u8 subjectType, u8 mask
+constexpr char          kBinaryMagic[4] = {'B', 'P', 'E', 'X'};
+constexpr std::uint8_t  kTagEnd         = 0;
+constexpr std::uint8_t  kTagGroup       = 1;
+constexpr std::uint8_t  kTagMember      = 2;
+constexpr std::uint8_t  kTagACE         = 3;
+constexpr std::uint32_t kMaxStringSize  = 4096;
+
+auto subjectTypeName(const int subjectType) -> std::string_view { return subjectType == 0 ? "player" : "group"; }
+
+class RecordWriter {
+public:
+    virtual ~RecordWriter()                   = default;
+    virtual void write(const Record& record) = 0;
+    virtual void finish() {}
+};
+
+class JsonLinesWriter final : public RecordWriter {
+public:
+    explicit JsonLinesWriter(std::ostream& out) : out_(out) {
+        out_ << nlohmann::ordered_json{{"type", "bakaperms"}, {"version", kFormatVersion}}.dump() << '\n';
+    }
+
+    void write(const Record& record) override {
+        nlohmann::ordered_json json;
+        if (const auto* group = std::get_if<core::GroupInfo>(&record)) {
+            json = {{"type", "group"}, {"uuid", group->uuid}, {"name", group->name}, {"parent", nullptr}};
+            if (group->parentUuid) json["parent"] = *group->parentUuid;
+        } else if (const auto* member = std::get_if<MembershipRecord>(&record)) {
+            json = {{"type", "member"}, {"player", member->playerUuid}, {"group", member->groupUuid}};
+        } else {
+            const auto& [node, ace] = std::get<core::NodeACE>(record);
+            json["type"]            = "ace";
+            json["node"]            = node;
+            json["subject"]         = ace.subjectUuid;
+            json["subjectType"]     = subjectTypeName(ace.subjectType);
+            json["access"]          = ace.mask == core::AccessMask::Allow ? "allow" : "deny";
+        }
+        out_ << json.dump() << '\n';
+    }
+
+private:
+    std::ostream& out_;
+};
+
+class BinaryRecordWriter final : public RecordWriter {
+public:
+    explicit BinaryRecordWriter(std::ostream& out) : out_(out) {
+        out_.write(kBinaryMagic);
+        out_.write(static_cast<std::uint32_t>(kFormatVersion));
+    }
+
+    void write(const Record& record) override {
+        if (const auto* group = std::get_if<core::GroupInfo>(&record)) {
+            out_.write(kTagGroup);
+            out_.writeString(group->uuid);
+            out_.writeString(group->name);
+            out_.write(static_cast<std::uint8_t>(group->parentUuid.has_value()));
+            if (group->parentUuid) out_.writeString(*group->parentUuid);
+        } else if (const auto* member = std::get_if<MembershipRecord>(&record)) {
+            out_.write(kTagMember);
+            out_.writeString(member->playerUuid);
+            out_.writeString(member->groupUuid);
+        } else {
+            const auto& [node, ace] = std::get<core::NodeACE>(record);
+            out_.write(kTagACE);
+            out_.writeString(node);
+            out_.writeString(ace.subjectUuid);
+            out_.write(static_cast<std::uint8_t>(ace.subjectType));
+            out_.write(static_cast<std::uint8_t>(ace.mask));
+        }
+    }
+
+    void finish() override { out_.write(kTagEnd); }
+
+private:
+    utils::io::BinaryWriter out_;
+};
+
+class RecordReader {
+public:
+    virtual ~RecordReader() = default;
+    /// Read the next record; false at the end of the stream. Throws std::runtime_error on malformed input.
+    virtual bool next(Record& record) = 0;
+};
+
+class JsonLinesReader final : public RecordReader {
+public:
+    explicit JsonLinesReader(std::istream& in) : in_(in) {
+        const auto header = nextObject();
+        if (!header || header->value("type", "") != "bakaperms" || header->value("version", 0) != kFormatVersion) {
+            throw std::runtime_error("Not a BakaPerms JSON Lines export");
+        }
+    }
+
+    bool next(Record& record) override {
+        const auto json = nextObject();
+        if (!json) return false;
+        try {
+            const auto type = json->at("type").get<std::string>();
+            if (type == "group") {
+                core::GroupInfo group{.uuid = json->at("uuid"), .name = json->at("name"), .parentUuid = std::nullopt};
+                if (const auto& parent = json->at("parent"); !parent.is_null()) group.parentUuid = parent;
+                record = std::move(group);
+            } else if (type == "member") {
+                record = MembershipRecord{.playerUuid = json->at("player"), .groupUuid = json->at("group")};
+            } else if (type == "ace") {
+                const auto subjectType = json->at("subjectType").get<std::string>();
+                const auto access      = json->at("access").get<std::string>();
+                if ((subjectType != "player" && subjectType != "group") || (access != "allow" && access != "deny")) {
+                    throw std::runtime_error("invalid subjectType or access");
+                }
+                record = core::NodeACE{
+                    .node = json->at("node"),
+                    .ace  = {
+                             .orderIndex  = 0,
+                             .subjectUuid = json->at("subject"),
+                             .subjectType = subjectType == "player" ? 0 : 1,
+                             .mask        = access == "allow" ? core::AccessMask::Allow : core::AccessMask::Deny,
+                             },
+                };
+            } else {
+                throw std::runtime_error(std::format("unknown record type '{}'", type));
+            }
+        } catch (const std::exception& e) {
+            throw std::runtime_error(std::format("Line {}: {}", line_, e.what()));
+        }
+        return true;
+    }
+
+private:
+    auto nextObject() -> std::optional<nlohmann::json> {
+        std::string text;
+        while (std::getline(in_, text)) {
+            ++line_;
+            if (text.find_first_not_of(" \t\r") == std::string::npos) continue;
+            try {
+                return nlohmann::json::parse(text);
+            } catch (const nlohmann::json::parse_error& e) {
+                throw std::runtime_error(std::format("Line {}: {}", line_, e.what()));
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::istream& in_;
+    std::size_t   line_{0};
+};
+
+class BinaryRecordReader final : public RecordReader {
+public:
+    explicit BinaryRecordReader(std::istream& in) : in_(in) {
+        char          magic[sizeof(kBinaryMagic)]{};
+        std::uint32_t version = 0;
+        if (!in_.read(magic) || !std::equal(std::begin(magic), std::end(magic), kBinaryMagic) || !in_.read(version)
+            || version != static_cast<std::uint32_t>(kFormatVersion)) {
+            throw std::runtime_error("Not a BakaPerms binary export");
+        }
+    }
+
+    bool next(Record& record) override {
+        std::uint8_t tag = kTagEnd;
+        if (!in_.read(tag)) throw std::runtime_error("Binary export is truncated");
+        switch (tag) {
+        case kTagEnd:
+            return false;
+        case kTagGroup: {
+            core::GroupInfo group;
+            std::uint8_t    hasParent = 0;
+            require(in_.readString(group.uuid, kMaxStringSize) && in_.readString(group.name, kMaxStringSize)
+                    && in_.read(hasParent));
+            if (hasParent) require(in_.readString(group.parentUuid.emplace(), kMaxStringSize));
+            record = std::move(group);
+            return true;
+        }
+        case kTagMember: {
+            MembershipRecord member;
+            require(
+                in_.readString(member.playerUuid, kMaxStringSize) && in_.readString(member.groupUuid, kMaxStringSize)
+            );
+            record = std::move(member);
+            return true;
+        }
+        case kTagACE: {
+            core::NodeACE entry;
+            std::uint8_t  subjectType = 0;
+            std::uint8_t  mask        = 0;
+            require(
+                in_.readString(entry.node, kMaxStringSize) && in_.readString(entry.ace.subjectUuid, kMaxStringSize)
+                && in_.read(subjectType) && in_.read(mask) && subjectType <= 1 && mask <= 1
+            );
+            entry.ace.subjectType = subjectType;
+            entry.ace.mask        = static_cast<core::AccessMask>(mask);
+            record                = std::move(entry);
+            return true;
+        }
+        default:
+            throw std::runtime_error(std::format("Unknown record tag {} in binary export", tag));
+        }
+    }
+
+private:
+    static void require(const bool ok) {
+        if (!ok) throw std::runtime_error("Binary export is truncated or corrupt");
+    }
+
+    utils::io::BinaryReader in_;
+};
+
+} // namespace
+
+PermissionTransfer::PermissionTransfer(database::IDatabase& db, const PermissionRepository& repo)
+: db_(db),
+  repo_(repo) {}
+
+auto PermissionTransfer::exportTo(const std::filesystem::path& path, const core::TransferFormat format) const
+    -> core::TransferStats {
+    core::TransferStats stats;
+
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    try {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error(std::format("Cannot open {} for writing", tmpPath.string()));
+
+        std::unique_ptr<RecordWriter> writer;
+        if (format == core::TransferFormat::JsonLines) {
+            writer = std::make_unique<JsonLinesWriter>(out);
+        } else {
+            writer = std::make_unique<BinaryRecordWriter>(out);
+        }
+
+        repo_.forEachGroup([&](const core::GroupInfo& group) {
+            writer->write(group);
+            ++stats.groups;
+        });
+        repo_.forEachMembership([&](const std::string& playerUuid, const std::string& groupUuid) {
+            writer->write(MembershipRecord{.playerUuid = playerUuid, .groupUuid = groupUuid});
+            ++stats.memberships;
+        });
+        repo_.forEachACE([&](const std::string& node, const core::ACE& ace) {
+            writer->write(core::NodeACE{.node = node, .ace = ace});
+            ++stats.aces;
+        });
+        writer->finish();
+
+        if (!out.flush()) throw std::runtime_error(std::format("Failed to write {}", tmpPath.string()));
+    } catch (...) {
+        std::error_code ignored; // leave no partial export next to the real one
+        std::filesystem::remove(tmpPath, ignored);
+        throw;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::error_code ignored;
+        std::filesystem::remove(tmpPath, ignored);
+        throw std::runtime_error(std::format("Failed to replace {}: {}", path.string(), ec.message()));
+    }
+    return stats;
+}
+
+auto PermissionTransfer::importFrom(const std::filesystem::path& path, const core::TransferFormat format) const
+    -> core::TransferStats {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error(std::format("Cannot open {}", path.string()));
+
+    std::unique_ptr<RecordReader> reader;
+    if (format == core::TransferFormat::JsonLines) {
+        reader = std::make_unique<JsonLinesReader>(in);
+    } else {
+        reader = std::make_unique<BinaryRecordReader>(in);
+    }
+
+    core::TransferStats stats;
+    // Rows are written without change-log entries; each transaction logs one Reload entry instead, so
+    // other servers reload once per poll rather than re-reading every row the import touched.
+    const auto bulk = repo_.withoutChangeLog();
+    // A parent is applied at the end of the first batch by which its group exists, so files may list
+    // children before parents; only parents still waiting for their group are held.
+    std::vector<std::pair<std::string, std::optional<std::string>>> pendingParents;
+    const auto applyParents = [&](const bool all) {
+        std::erase_if(pendingParents, [&](const auto& pending) {
+            const auto& [uuid, parentUuid] = pending;
+            if (!all && parentUuid && !bulk.getGroup(*parentUuid)) return false;
+            bulk.setGroupParent(uuid, parentUuid ? std::optional<std::string_view>(*parentUuid) : std::nullopt);
+            return true;
+        });
+    };
+    // ACEs of one node are contiguous, as exportTo() writes them: the first ACE of each run replaces
+    // the node's ACL, the rest append to it.
+    std::string currentNode;
+    int         nextIndex = 0;
+
+    std::vector<Record> batch;
+    batch.reserve(kBatchSize);
+    const auto flush = [&] {
+        db_.withTransaction([&] {
+            for (const auto& record : batch) {
+                if (const auto* group = std::get_if<core::GroupInfo>(&record)) {
+                    bulk.upsertGroup(group->uuid, group->name);
+                    pendingParents.emplace_back(group->uuid, group->parentUuid);
+                    ++stats.groups;
+                } else if (const auto* member = std::get_if<MembershipRecord>(&record)) {
+                    (void)bulk.addPlayerToGroup(member->playerUuid, member->groupUuid);
+                    ++stats.memberships;
+                } else {
+                    const auto& [node, ace] = std::get<core::NodeACE>(record);
+                    if (node.empty()) throw std::runtime_error("ACE record with an empty node");
+                    if (node != currentNode) {
+                        bulk.clearNodeACL(node);
+                        currentNode = node;
+                        nextIndex   = 0;
+                    }
+                    bulk.putACE(node, nextIndex++, ace.subjectUuid, ace.subjectType, ace.mask);
+                    ++stats.aces;
+                }
+            }
+            applyParents(false);
+            repo_.logReload();
+        });
+        batch.clear();
+    };
+
+    for (Record record; reader->next(record);) {
+        batch.push_back(std::move(record));
+        if (batch.size() >= kBatchSize) flush();
+    }
+    if (!batch.empty()) flush();
+
+    // Anything left names a parent group that exists nowhere; it is applied as-is and the foreign key decides.
+    if (!pendingParents.empty()) {
+        db_.withTransaction([&] {
+            applyParents(true);
+            repo_.logReload();
+        });
+    }
+    return stats;
+}
+
+} // namespace BakaPerms::data
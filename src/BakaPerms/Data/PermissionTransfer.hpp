@@ -0,0 +1,36 @@
+#pragma once
+#include "BakaPerms/Core/Types.hpp"
+#include "BakaPerms/Data/PermissionRepository.hpp"
+#include "BakaPerms/Database/IDatabase.hpp"
+
+#include <filesystem>
+
+namespace BakaPerms::data {
+
+/// Streams the groups, player_groups and permissions tables to and from a file. Neither direction
+/// holds more than one page of rows or one import batch in memory, plus, while importing, the parent
+/// links of groups whose parent group has not been imported yet.
+///
+/// Records are written groups first, then memberships, then ACEs ordered by node and position.
+/// Importing merges into the existing data: groups are upserted by uuid, memberships are added,
+/// and every node that appears in the file has its ACL replaced by the file's ACEs. A node's ACEs
+/// must be contiguous; a node that reappears later replaces the ACEs imported for it before.
+class PermissionTransfer {
+public:
+    PermissionTransfer(database::IDatabase& db, const PermissionRepository& repo);
+
+    auto exportTo(const std::filesystem::path& path, core::TransferFormat format) const -> core::TransferStats;
+
+    /// Each batch of records is committed in its own transaction, with a single ChangeKind::Reload
+    /// change-log entry in place of per-row entries. A malformed record aborts the import with
+    /// std::runtime_error; batches committed before it are kept.
+    auto importFrom(const std::filesystem::path& path, core::TransferFormat format) const -> core::TransferStats;
+
+    static constexpr std::size_t kBatchSize = 5000;
+
+private:
+    database::IDatabase&        db_;
+    const PermissionRepository& repo_;
+};
+
+} // namespace BakaPerms::data
@@ -0,0 +1,37 @@
+#pragma once
+#include "BakaPerms/Core/Types.hpp"
+#include "BakaPerms/Database/RowDecoder.hpp"
+
+#include <format>
+#include <stdexcept>
+
+// Column layouts the repository selects core types with.
+namespace BakaPerms::database {
+
+template <>
+struct RowDecoder<core::AccessMask> {
+    static constexpr std::size_t kColumns = 1;
+    static auto decode(const RowView& row, const std::size_t column) -> core::AccessMask {
+        const auto value = row.getInt(column);
+        if (value != static_cast<int>(core::AccessMask::Deny) && value != static_cast<int>(core::AccessMask::Allow)) {
+            throw std::out_of_range(std::format("Invalid access_mask value in database: {}", value));
+        }
+        return static_cast<core::AccessMask>(value);
+    }
+};
+
+// uuid, name, parent_uuid
+template <>
+struct RowDecoder<core::GroupInfo>
+: MemberDecoder<&core::GroupInfo::uuid, &core::GroupInfo::name, &core::GroupInfo::parentUuid> {};
+
+// position, subject_uuid, subject_type, access_mask
+template <>
+struct RowDecoder<core::ACE>
+: MemberDecoder<&core::ACE::orderIndex, &core::ACE::subjectUuid, &core::ACE::subjectType, &core::ACE::mask> {};
+
+// node, then the ACE columns
+template <>
+struct RowDecoder<core::NodeACE> : MemberDecoder<&core::NodeACE::node, &core::NodeACE::ace> {};
+
+} // namespace BakaPerms::database
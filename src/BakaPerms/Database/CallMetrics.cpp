@@ -0,0 +1,52 @@
+#include "BakaPerms/Database/CallMetrics.hpp"
+
+#include <exception>
+#include <string_view>
+
+namespace BakaPerms::database {
+
+namespace {
+
+// Label values of DbCall, in order.
+constexpr std::array<std::string_view, static_cast<std::size_t>(DbCall::Count)> kCallLabels = {
+    R"(op="exec")",
+    R"(op="execute")",
+    R"(op="query")",
+    R"(op="queryOne")",
+    R"(op="exists")",
+    R"(op="forEachRow")",
+    R"(op="batch")",
+    R"(op="transaction")",
+};
+
+} // namespace
+
+CallMetrics::Scope::Scope(Entry& entry)
+: entry_(entry),
+  timer_(entry.latency),
+  exceptions_(std::uncaught_exceptions()) {}
+
+CallMetrics::Scope::~Scope() {
+    if (std::uncaught_exceptions() > exceptions_) entry_.failures.add();
+}
+
+void CallMetrics::collect(utils::metrics::MetricVisitor& visitor) const {
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+        visitor.histogram(
+            "bakaperms_sql_seconds",
+            "Time spent in database calls, including waiting for a connection.",
+            kCallLabels[i],
+            entries_[i].latency.snapshot()
+        );
+    }
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+        visitor.counter(
+            "bakaperms_sql_failures_total",
+            "Database calls that ended with an exception.",
+            kCallLabels[i],
+            entries_[i].failures.value()
+        );
+    }
+}
+
+} // namespace BakaPerms::database
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "BakaPerms/Utils/Metrics/Metrics.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace BakaPerms::database {
+
+/// IDatabase entry points timed separately by CallMetrics.
+enum class DbCall : std::uint8_t { Exec, Execute, Query, QueryOne, Exists, ForEachRow, Batch, Transaction, Count };
+
+/// Latency and failure count of each IDatabase entry point, reported as bakaperms_sql_seconds and
+/// bakaperms_sql_failures_total with an op label.
+class CallMetrics {
+    struct Entry {
+        utils::metrics::LatencyHistogram latency;
+        utils::metrics::Counter          failures; // calls left by an exception
+    };
+
+public:
+    /// Times the enclosing call and counts it as failed if it unwinds.
+    class Scope {
+    public:
+        Scope(const Scope&)            = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope();
+
+    private:
+        friend class CallMetrics;
+        explicit Scope(Entry& entry);
+
+        Entry&                      entry_;
+        utils::metrics::ScopedTimer timer_;
+        int                         exceptions_;
+    };
+
+    [[nodiscard]] auto scope(DbCall call) -> Scope { return Scope(entries_[static_cast<std::size_t>(call)]); }
+
+    void collect(utils::metrics::MetricVisitor& visitor) const;
+
+private:
+    std::array<Entry, static_cast<std::size_t>(DbCall::Count)> entries_;
+};
+
+} // namespace BakaPerms::database
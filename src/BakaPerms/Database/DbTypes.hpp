@@ -1,7 +1,9 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -12,7 +14,6 @@ struct DbNull {
 };
 
 using DbValue   = std::variant<DbNull, int, std::int64_t, double, std::string>;
-using ParamList = std::vector<DbValue>;
 
 class Row {
     std::vector<DbValue> columns_;
@@ -55,4 +56,46 @@ class Row {
 
 using ResultSet = std::vector<Row>;
 
+/// Time one statement call spent in each phase, and the rows it produced.
+struct StatementPhases {
+    std::chrono::nanoseconds lockWait{0}; // waiting for a connection or the writer lock
+    std::chrono::nanoseconds prepare{0};  // preparing or fetching the statement, and binding
+    std::chrono::nanoseconds step{0};     // executing and stepping the statement
+    std::chrono::nanoseconds extract{0};  // copying or decoding rows, including forEachRow callbacks
+    std::uint64_t            rows{0};
+
+    [[nodiscard]] auto total() const -> std::chrono::nanoseconds { return lockWait + prepare + step + extract; }
+
+    auto operator+=(const StatementPhases& other) -> StatementPhases& {
+        lockWait += other.lockWait;
+        prepare  += other.prepare;
+        step     += other.step;
+        extract  += other.extract;
+        rows     += other.rows;
+        return *this;
+    }
+};
+
+/// Phases summed over every successful call with the same SQL text.
+struct StatementProfile {
+    std::string              sql;
+    std::uint64_t            calls{0};
+    StatementPhases          totals;
+    std::chrono::nanoseconds slowest{0}; // longest single call
+};
+
+/// The current row of a query being stepped by IDatabase::forEachRow. Values are read straight from
+/// the driver; text views are only valid until the callback returns.
+class RowView {
+public:
+    virtual ~RowView() = default;
+
+    [[nodiscard]] virtual auto columnCount() const -> std::size_t                   = 0;
+    [[nodiscard]] virtual bool isNull(std::size_t index) const                      = 0;
+    [[nodiscard]] virtual auto getInt(std::size_t index) const -> int               = 0;
+    [[nodiscard]] virtual auto getInt64(std::size_t index) const -> std::int64_t    = 0;
+    [[nodiscard]] virtual auto getDouble(std::size_t index) const -> double         = 0;
+    [[nodiscard]] virtual auto getText(std::size_t index) const -> std::string_view = 0;
+};
+
 } // namespace BakaPerms::database
@@ -1,13 +1,26 @@
 #pragma once
 
 #include "BakaPerms/Database/DbTypes.hpp"
+#include "BakaPerms/Database/Params.hpp"
+#include "BakaPerms/Database/RowDecoder.hpp"
+#include "BakaPerms/Utils/Metrics/Metrics.hpp"
 
+#include <array>
 #include <functional>
 #include <optional>
+#include <span>
 #include <string_view>
+#include <vector>
 
 namespace BakaPerms::database {
 
+/// One SELECT of a forEachRowBatch() call. `sql` and `params` must outlive the call.
+struct BatchQuery {
+    std::string_view                    sql;
+    ParamSpan                           params;
+    std::function<void(const RowView&)> fn;
+};
+
 class IDatabase {
 public:
     virtual ~IDatabase()                   = default;
@@ -18,28 +31,95 @@ class IDatabase {
     virtual void exec(std::string_view sql) = 0;
 
     /// Execute DML with parameters; returns affected row count.
-    virtual auto execute(std::string_view sql, const ParamList& params) -> int = 0;
+    virtual auto execute(std::string_view sql, ParamSpan params) -> int = 0;
 
     /// Execute SELECT and return all matching rows.
-    virtual auto query(std::string_view sql, const ParamList& params) -> ResultSet = 0;
+    virtual auto query(std::string_view sql, ParamSpan params) -> ResultSet = 0;
 
     /// Execute SELECT and return only the first row, or std::nullopt.
-    virtual auto queryOne(std::string_view sql, const ParamList& params) -> std::optional<Row> = 0;
+    virtual auto queryOne(std::string_view sql, ParamSpan params) -> std::optional<Row> = 0;
 
     /// Return true if the SELECT yields at least one row.
-    virtual bool exists(std::string_view sql, const ParamList& params) = 0;
+    virtual bool exists(std::string_view sql, ParamSpan params) = 0;
+
+    /// Execute SELECT and call `fn` on each row as it is stepped, without building a ResultSet.
+    /// `fn` must not use this database; exceptions it throws abort the query and propagate.
+    virtual void forEachRow(std::string_view sql, ParamSpan params, const std::function<void(const RowView&)>& fn) = 0;
+
+    /// Run several SELECTs against one consistent view of the database, calling each query's `fn`
+    /// on its rows in order. Network backends send the whole batch in a single round trip. The
+    /// same restrictions as forEachRow() apply to every `fn`.
+    virtual void forEachRowBatch(std::span<const BatchQuery> batch) = 0;
 
     /// Execute a function within a transaction. Commits on success, rolls back on exception.
+    /// A call made from inside `fn` joins the outer transaction instead of starting its own.
     virtual void withTransaction(const std::function<void()>& fn) = 0;
 
-    // Non-virtual convenience overloads (no params).
-    auto execute(const std::string_view sql) -> int { return execute(sql, {}); }
-    auto query(const std::string_view sql) -> ResultSet { return query(sql, {}); }
-    auto queryOne(const std::string_view sql) -> std::optional<Row> { return queryOne(sql, {}); }
-    bool exists(const std::string_view sql) { return exists(sql, {}); }
+    /// Report call latencies, failures and other backend statistics to `visitor`.
+    virtual void collectMetrics(utils::metrics::MetricVisitor& visitor) = 0;
+
+    /// Per-SQL-text timings, most total time first.
+    virtual auto getStatementProfiles() -> std::vector<StatementProfile> = 0;
+
+    // Typed overloads: each argument is bound in place from a stack array, and the number of '?'
+    // placeholders in the SQL literal is checked against the argument count at compile time.
+    // SQL built at run time goes through the ParamSpan overloads above.
+    template <Bindable... Args>
+    auto execute(const SqlFor<Args...> sql, const Args&... args) -> int {
+        return execute(sql.view(), bind(args...));
+    }
+    template <Bindable... Args>
+    auto query(const SqlFor<Args...> sql, const Args&... args) -> ResultSet {
+        return query(sql.view(), bind(args...));
+    }
+    template <Bindable... Args>
+    auto queryOne(const SqlFor<Args...> sql, const Args&... args) -> std::optional<Row> {
+        return queryOne(sql.view(), bind(args...));
+    }
+    template <Bindable... Args>
+    bool exists(const SqlFor<Args...> sql, const Args&... args) {
+        return exists(sql.view(), bind(args...));
+    }
+    template <Bindable... Args>
+    void forEachRow(const SqlFor<Args...> sql, const std::function<void(const RowView&)>& fn, const Args&... args) {
+        forEachRow(sql.view(), bind(args...), fn);
+    }
+
+    /// Execute SELECT and decode every row with RowDecoder<T>.
+    template <typename T>
+    auto queryAs(const std::string_view sql, const ParamSpan params) -> std::vector<T> {
+        std::vector<T> result;
+        forEachRow(sql, params, [&result](const RowView& row) { result.push_back(RowDecoder<T>::decode(row, 0)); });
+        return result;
+    }
+    template <typename T, Bindable... Args>
+    auto queryAs(const SqlFor<Args...> sql, const Args&... args) -> std::vector<T> {
+        return queryAs<T>(sql.view(), bind(args...));
+    }
+
+    /// Same as queryAs() for a SELECT that yields at most one row.
+    template <typename T>
+    auto queryOneAs(const std::string_view sql, const ParamSpan params) -> std::optional<T> {
+        std::optional<T> result;
+        forEachRow(sql, params, [&result](const RowView& row) {
+            if (!result) result = RowDecoder<T>::decode(row, 0);
+        });
+        return result;
+    }
+    template <typename T, Bindable... Args>
+    auto queryOneAs(const SqlFor<Args...> sql, const Args&... args) -> std::optional<T> {
+        return queryOneAs<T>(sql.view(), bind(args...));
+    }
 
 protected:
     IDatabase() = default;
+
+private:
+    // Views into `args`, which the caller keeps alive for the whole statement.
+    template <typename... Args>
+    static auto bind(const Args&... args) -> std::array<DbParam, sizeof...(Args)> {
+        return {detail::toParam(args)...};
+    }
 };
 
 } // namespace BakaPerms::database
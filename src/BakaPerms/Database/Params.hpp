@@ -0,0 +1,83 @@
+#pragma once
+
+#include "BakaPerms/Database/DbTypes.hpp"
+
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+namespace BakaPerms::database {
+
+/// A statement parameter that borrows its value: text is handed to the driver as a view, so the
+/// referenced string must outlive the call it is passed to.
+using DbParam   = std::variant<DbNull, int, std::int64_t, double, std::string_view>;
+using ParamSpan = std::span<const DbParam>;
+
+namespace detail {
+
+inline auto toParam(DbNull) -> DbParam { return DbNull{}; }
+inline auto toParam(std::nullopt_t) -> DbParam { return DbNull{}; }
+inline auto toParam(const int value) -> DbParam { return value; }
+inline auto toParam(const std::int64_t value) -> DbParam { return value; }
+inline auto toParam(const double value) -> DbParam { return value; }
+inline auto toParam(const std::string_view value) -> DbParam { return value; }
+
+template <typename T>
+auto toParam(const std::optional<T>& value) -> DbParam {
+    return value ? toParam(*value) : DbParam{DbNull{}};
+}
+
+// '?' placeholders outside quoted literals and identifiers.
+consteval auto countPlaceholders(const std::string_view sql) -> std::size_t {
+    std::size_t count = 0;
+    char        quote = 0;
+    for (const char c : sql) {
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+        } else if (c == '?') {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Not constexpr: reaching it from Sql's constructor turns a mismatch into a compile error that names it.
+inline void sqlPlaceholderCountDoesNotMatchArguments() {}
+
+} // namespace detail
+
+/// Types that can be passed to the typed IDatabase calls: integers, doubles, nulls and anything
+/// viewable as text, optionally wrapped in std::optional (nullopt binds NULL).
+template <typename T>
+concept Bindable = requires(const T& value) {
+    { detail::toParam(value) } -> std::same_as<DbParam>;
+};
+
+/// SQL text checked at compile time against the arguments it is called with: the literal must
+/// contain exactly one '?' per argument. Use SqlFor<Args...> in signatures so Args are deduced
+/// from the arguments only.
+template <typename... Args>
+class Sql {
+public:
+    template <typename S>
+        requires std::convertible_to<const S&, std::string_view>
+    consteval Sql(const S& text) : text_(text) {
+        if (detail::countPlaceholders(text_) != sizeof...(Args)) detail::sqlPlaceholderCountDoesNotMatchArguments();
+    }
+
+    [[nodiscard]] constexpr auto view() const noexcept -> std::string_view { return text_; }
+
+private:
+    std::string_view text_;
+};
+
+template <typename... Args>
+using SqlFor = Sql<std::type_identity_t<Args>...>;
+
+} // namespace BakaPerms::database
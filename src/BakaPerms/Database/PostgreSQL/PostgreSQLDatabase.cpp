@@ -0,0 +1,735 @@
+#include "BakaPerms/Database/PostgreSQL/PostgreSQLDatabase.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <exception>
+#include <format>
+
+namespace BakaPerms::database {
+
+namespace {
+
+// Type OIDs from pg_type, for the parameter and result types this backend handles.
+constexpr Oid kBoolOid    = 16;
+constexpr Oid kInt8Oid    = 20;
+constexpr Oid kInt2Oid    = 21;
+constexpr Oid kInt4Oid    = 23;
+constexpr Oid kTextOid    = 25;
+constexpr Oid kFloat4Oid  = 700;
+constexpr Oid kFloat8Oid  = 701;
+constexpr Oid kNumericOid = 1700;
+
+constexpr int kTextFormat   = 0;
+constexpr int kBinaryFormat = 1;
+
+// Opens the read-only transaction of a batch that runs outside withTransaction(). REPEATABLE READ
+// takes one snapshot for all of its statements.
+constexpr auto kBeginBatchSql = "BEGIN ISOLATION LEVEL REPEATABLE READ READ ONLY";
+
+struct PositionalSql {
+    std::string text;
+    std::size_t paramCount;
+};
+
+// Rewrites '?' placeholders to $1, $2, ..., skipping quoted literals and identifiers the same way
+// detail::countPlaceholders() does.
+auto toPositional(const std::string_view sql) -> PositionalSql {
+    PositionalSql result{.text = {}, .paramCount = 0};
+    result.text.reserve(sql.size() + 8);
+    char quote = 0;
+    for (const char c : sql) {
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+        } else if (c == '?') {
+            std::format_to(std::back_inserter(result.text), "${}", ++result.paramCount);
+            continue;
+        }
+        result.text += c;
+    }
+    return result;
+}
+
+void checkParamCount(const std::size_t expected, const ParamSpan params) {
+    if (params.size() != expected) {
+        throw DatabaseException(
+            DbErrorCode::BindError,
+            std::format("Statement expects {} parameters, got {}", expected, params.size())
+        );
+    }
+}
+
+// libpq's parameter arrays for one call. Text is sent in binary format, which for text is its
+// bytes as they are, so the views are passed through without a copy; numbers go as text.
+class BoundParams {
+public:
+    explicit BoundParams(const ParamSpan params)
+    : types_(params.size()),
+      values_(params.size()),
+      lengths_(params.size()),
+      formats_(params.size()),
+      digits_(params.size()) {
+        for (std::size_t i = 0; i < params.size(); ++i) {
+            std::visit([this, i]<typename Ty>(const Ty& val) { set(i, val); }, params[i]);
+        }
+    }
+
+    [[nodiscard]] auto count() const -> int { return static_cast<int>(values_.size()); }
+    [[nodiscard]] auto types() const -> const Oid* { return types_.data(); }
+    [[nodiscard]] auto values() const -> const char* const* { return values_.data(); }
+    [[nodiscard]] auto lengths() const -> const int* { return lengths_.data(); }
+    [[nodiscard]] auto formats() const -> const int* { return formats_.data(); }
+
+private:
+    void set(const std::size_t i, DbNull) {
+        types_[i]  = 0; // inferred by the server
+        values_[i] = nullptr;
+    }
+    void set(const std::size_t i, const std::string_view val) {
+        types_[i]   = kTextOid;
+        values_[i]  = val.data() ? val.data() : ""; // a null pointer would bind NULL
+        lengths_[i] = static_cast<int>(val.size());
+        formats_[i] = kBinaryFormat;
+    }
+    template <typename T>
+    void set(const std::size_t i, const T val) {
+        if constexpr (std::is_same_v<T, int>) types_[i] = kInt4Oid;
+        else if constexpr (std::is_same_v<T, std::int64_t>) types_[i] = kInt8Oid;
+        else types_[i] = kFloat8Oid;
+        auto&      buffer = digits_[i];
+        const auto end    = std::to_chars(buffer.data(), buffer.data() + buffer.size() - 1, val).ptr;
+        *end              = '\0';
+        values_[i]        = buffer.data();
+        formats_[i]       = kTextFormat;
+    }
+
+    std::vector<Oid>                  types_;
+    std::vector<const char*>          values_;
+    std::vector<int>                  lengths_;
+    std::vector<int>                  formats_;
+    std::vector<std::array<char, 32>> digits_; // text of numeric parameters
+};
+
+// Current row of a text-format result; text columns are views into libpq's buffer.
+class ResultRowView final : public RowView {
+public:
+    explicit ResultRowView(const PGresult* result) : result_(result) {}
+
+    void seek(const int row) { row_ = row; }
+
+    [[nodiscard]] auto columnCount() const -> std::size_t override {
+        return static_cast<std::size_t>(PQnfields(result_));
+    }
+    [[nodiscard]] bool isNull(const std::size_t index) const override {
+        return PQgetisnull(result_, row_, static_cast<int>(index)) != 0;
+    }
+    [[nodiscard]] auto getInt(const std::size_t index) const -> int override { return parse<int>(index); }
+    [[nodiscard]] auto getInt64(const std::size_t index) const -> std::int64_t override {
+        return parse<std::int64_t>(index);
+    }
+    [[nodiscard]] auto getDouble(const std::size_t index) const -> double override { return parse<double>(index); }
+    [[nodiscard]] auto getText(const std::size_t index) const -> std::string_view override {
+        const int column = static_cast<int>(index);
+        return {PQgetvalue(result_, row_, column), static_cast<std::size_t>(PQgetlength(result_, row_, column))};
+    }
+
+private:
+    // NULL reads as 0 and booleans as 0 or 1, as they do from SQLite.
+    template <typename T>
+    [[nodiscard]] auto parse(const std::size_t index) const -> T {
+        if (isNull(index)) return T{};
+        const auto text = getText(index);
+        if (PQftype(result_, static_cast<int>(index)) == kBoolOid) return text == "t" ? T{1} : T{0};
+        T value{};
+        if (std::from_chars(text.data(), text.data() + text.size(), value).ec != std::errc{}) {
+            throw DatabaseException(
+                DbErrorCode::QueryFailed,
+                std::format("Column {} is not a number: '{}'", index, text)
+            );
+        }
+        return value;
+    }
+
+    const PGresult* result_;
+    int             row_{0};
+};
+
+auto extractRow(const ResultRowView& view, const PGresult* result) -> Row {
+    const auto           count = view.columnCount();
+    std::vector<DbValue> columns;
+    columns.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (view.isNull(i)) {
+            columns.emplace_back(DbNull{});
+            continue;
+        }
+        switch (PQftype(result, static_cast<int>(i))) {
+        case kBoolOid:
+        case kInt2Oid:
+        case kInt4Oid:
+        case kInt8Oid:
+            columns.emplace_back(view.getInt64(i));
+            break;
+        case kFloat4Oid:
+        case kFloat8Oid:
+        case kNumericOid:
+            columns.emplace_back(view.getDouble(i));
+            break;
+        default:
+            columns.emplace_back(std::string(view.getText(i)));
+            break;
+        }
+    }
+    return Row(std::move(columns));
+}
+
+// libpq messages end with a newline.
+auto trimmed(const char* message) -> std::string {
+    std::string_view text = message ? message : "";
+    while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) text.remove_suffix(1);
+    return std::string(text);
+}
+
+} // namespace
+
+PostgreSQLDatabase::PostgreSQLDatabase(const PostgreSQLOptions& options)
+: options_(options),
+  profiler_(options.profiledStatements),
+  slowQueries_(options.slowQueryThreshold, options.slowQueryInterval) {
+    writer_ = openConnection(options, true);
+    readers_.reserve(options.readConnections);
+    idleReaders_.reserve(options.readConnections);
+    for (std::size_t i = 0; i < options.readConnections; ++i) {
+        readers_.push_back(openConnection(options, false));
+        idleReaders_.push_back(readers_.back().get());
+    }
+}
+
+PostgreSQLDatabase::~PostgreSQLDatabase() = default;
+
+auto PostgreSQLDatabase::openConnection(const PostgreSQLOptions& options, const bool writer)
+    -> std::unique_ptr<Connection> {
+    const auto port    = std::to_string(options.port);
+    const auto timeout = std::to_string(options.connectTimeoutSeconds);
+    // Read connections reject any write, like SQLite's query_only.
+    const std::array<const char*, 10> keywords = {
+        "host",
+        "port",
+        "user",
+        "password",
+        "dbname",
+        "sslmode",
+        "connect_timeout",
+        "application_name",
+        "options",
+        nullptr,
+    };
+    const std::array<const char*, 10> values = {
+        options.host.c_str(),
+        port.c_str(),
+        options.user.c_str(),
+        options.password.c_str(),
+        options.database.c_str(),
+        options.sslMode.c_str(),
+        timeout.c_str(),
+        "BakaPerms",
+        writer ? "" : "-c default_transaction_read_only=on",
+        nullptr,
+    };
+
+    auto conn = std::make_unique<Connection>();
+    conn->pg.reset(PQconnectdbParams(keywords.data(), values.data(), 0));
+    if (!conn->pg) throw DatabaseException(DbErrorCode::ConnectionFailed, "Out of memory allocating a connection");
+    if (PQstatus(conn->pg.get()) != CONNECTION_OK) {
+        throw DatabaseException(DbErrorCode::ConnectionFailed, trimmed(PQerrorMessage(conn->pg.get())));
+    }
+    return conn;
+}
+
+PostgreSQLDatabase::ReaderLease::ReaderLease(PostgreSQLDatabase& owner) : owner_(owner) {
+    std::unique_lock lock(owner_.poolMutex_);
+    owner_.poolCv_.wait(lock, [this] { return !owner_.idleReaders_.empty(); });
+    conn_ = owner_.idleReaders_.back();
+    owner_.idleReaders_.pop_back();
+}
+
+PostgreSQLDatabase::ReaderLease::~ReaderLease() {
+    {
+        std::lock_guard lock(owner_.poolMutex_);
+        owner_.idleReaders_.push_back(conn_);
+    }
+    owner_.poolCv_.notify_one();
+}
+
+template <typename Fn>
+auto PostgreSQLDatabase::withReader(Fn&& fn) -> decltype(fn(std::declval<Connection&>())) {
+    if (readers_.empty() || txnOwner_.load(std::memory_order_acquire) == std::this_thread::get_id()) {
+        std::lock_guard lock(writerMutex_);
+        return fn(*writer_);
+    }
+    const ReaderLease lease(*this);
+    return fn(lease.get());
+}
+
+void PostgreSQLDatabase::exec(const std::string_view sql) {
+    const auto      scope = calls_.scope(DbCall::Exec);
+    PhaseClock      clock;
+    StatementPhases phases;
+    std::lock_guard lock(writerMutex_);
+    phases.lockWait = clock.lap();
+    // The simple protocol, so `sql` may hold several statements.
+    const ResultPtr result(PQexec(writer_->pg.get(), std::string(sql).c_str()));
+    phases.step = clock.lap();
+    if (const auto status = PQresultStatus(result.get());
+        status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK && status != PGRES_EMPTY_QUERY) {
+        fail(*writer_, result.get());
+    }
+    finishStatement(*writer_, sql, phases);
+}
+
+int PostgreSQLDatabase::execute(const std::string_view sql, const ParamSpan params) {
+    const auto      scope = calls_.scope(DbCall::Execute);
+    PhaseClock      clock;
+    StatementPhases phases;
+    std::lock_guard lock(writerMutex_);
+    phases.lockWait   = clock.lap();
+    const auto result = run(*writer_, sql, params, phases, clock);
+    if (PQresultStatus(result.get()) != PGRES_COMMAND_OK) check(*writer_, result.get(), PGRES_TUPLES_OK);
+    const std::string_view affected = PQcmdTuples(result.get());
+    int                    changes  = 0;
+    std::from_chars(affected.data(), affected.data() + affected.size(), changes);
+    finishStatement(*writer_, sql, phases);
+    return changes;
+}
+
+ResultSet PostgreSQLDatabase::query(const std::string_view sql, const ParamSpan params) {
+    const auto scope = calls_.scope(DbCall::Query);
+    PhaseClock clock;
+    return withReader([&](Connection& conn) {
+        StatementPhases phases;
+        phases.lockWait   = clock.lap();
+        const auto result = run(conn, sql, params, phases, clock);
+        check(conn, result.get(), PGRES_TUPLES_OK);
+        ResultRowView row(result.get());
+        ResultSet     results;
+        results.reserve(static_cast<std::size_t>(PQntuples(result.get())));
+        for (int i = 0; i < PQntuples(result.get()); ++i) {
+            row.seek(i);
+            results.push_back(extractRow(row, result.get()));
+        }
+        phases.extract = clock.lap();
+        phases.rows    = results.size();
+        finishStatement(conn, sql, phases);
+        return results;
+    });
+}
+
+std::optional<Row> PostgreSQLDatabase::queryOne(const std::string_view sql, const ParamSpan params) {
+    const auto scope = calls_.scope(DbCall::QueryOne);
+    PhaseClock clock;
+    return withReader([&](Connection& conn) -> std::optional<Row> {
+        StatementPhases phases;
+        phases.lockWait   = clock.lap();
+        const auto result = run(conn, sql, params, phases, clock);
+        check(conn, result.get(), PGRES_TUPLES_OK);
+        std::optional<Row> row;
+        if (PQntuples(result.get()) > 0) {
+            row            = extractRow(ResultRowView(result.get()), result.get());
+            phases.extract = clock.lap();
+            phases.rows    = 1;
+        }
+        finishStatement(conn, sql, phases);
+        return row;
+    });
+}
+
+bool PostgreSQLDatabase::exists(const std::string_view sql, const ParamSpan params) {
+    const auto scope = calls_.scope(DbCall::Exists);
+    PhaseClock clock;
+    return withReader([&](Connection& conn) {
+        StatementPhases phases;
+        phases.lockWait   = clock.lap();
+        const auto result = run(conn, sql, params, phases, clock);
+        check(conn, result.get(), PGRES_TUPLES_OK);
+        const bool found = PQntuples(result.get()) > 0;
+        phases.rows      = found ? 1 : 0;
+        finishStatement(conn, sql, phases);
+        return found;
+    });
+}
+
+void PostgreSQLDatabase::forEachRow(
+    const std::string_view                     sql,
+    const ParamSpan                            params,
+    const std::function<void(const RowView&)>& fn
+) {
+    const auto scope = calls_.scope(DbCall::ForEachRow);
+    PhaseClock clock;
+    withReader([&](Connection& conn) {
+        StatementPhases phases;
+        phases.lockWait   = clock.lap();
+        const auto result = run(conn, sql, params, phases, clock);
+        check(conn, result.get(), PGRES_TUPLES_OK);
+        ResultRowView row(result.get());
+        for (int i = 0; i < PQntuples(result.get()); ++i) {
+            row.seek(i);
+            fn(row);
+        }
+        phases.extract = clock.lap();
+        phases.rows    = static_cast<std::uint64_t>(PQntuples(result.get()));
+        finishStatement(conn, sql, phases);
+    });
+}
+
+void PostgreSQLDatabase::forEachRowBatch(const std::span<const BatchQuery> batch) {
+    const auto scope = calls_.scope(DbCall::Batch);
+    PhaseClock clock;
+    withReader([&](Connection& conn) {
+        PGconn*                      pg = conn.pg.get();
+        std::vector<StatementPhases> phases(batch.size());
+        if (!batch.empty()) phases.front().lockWait = clock.lap();
+
+        // Resolve every statement before anything is sent, so a bind error leaves the connection
+        // as it was. A text not prepared yet is prepared in the same pipeline, unless the cache is
+        // full or an earlier query of the batch is preparing it already; those run unnamed.
+        const auto                 capacity = options_.statementCacheSize;
+        std::vector<std::string>   names(batch.size());      // empty: run unnamed
+        std::vector<PositionalSql> unprepared(batch.size()); // positional text of statements not prepared yet
+        auto                       room = capacity - std::min(conn.prepared.size(), capacity);
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            const auto& query = batch[i];
+            if (const auto it = conn.prepared.find(query.sql); it != conn.prepared.end()) {
+                conn.hits.fetch_add(1, std::memory_order_relaxed);
+                checkParamCount(it->second.paramCount, query.params);
+                names[i] = it->second.name;
+                continue;
+            }
+            conn.misses.fetch_add(1, std::memory_order_relaxed);
+            unprepared[i] = toPositional(query.sql);
+            checkParamCount(unprepared[i].paramCount, query.params);
+            const bool repeated = std::ranges::any_of(batch.first(i), [&](const BatchQuery& earlier) {
+                return earlier.sql == query.sql;
+            });
+            if (room > 0 && !repeated) {
+                --room;
+                names[i] = std::format("s{}", conn.nextStatementId++);
+            }
+        }
+
+        // Every command sent, in order; the server answers each with one result.
+        enum class Step : std::uint8_t { Begin, Prepare, Query, Commit };
+        std::vector<std::pair<Step, std::size_t>> steps;
+        steps.reserve(batch.size() * 2 + 2);
+
+        // Inside withTransaction() the batch runs in the caller's transaction, which already sees
+        // one state; otherwise it opens its own.
+        const bool ownTxn = PQtransactionStatus(pg) == PQTRANS_IDLE;
+        if (PQenterPipelineMode(pg) != 1) fail(conn, nullptr);
+        const auto sendCommand = [pg](const char* sql) {
+            return PQsendQueryParams(pg, sql, 0, nullptr, nullptr, nullptr, nullptr, kTextFormat) == 1;
+        };
+        bool sent = !ownTxn || sendCommand(kBeginBatchSql);
+        if (sent && ownTxn) steps.emplace_back(Step::Begin, 0);
+        for (std::size_t i = 0; sent && i < batch.size(); ++i) {
+            const BoundParams params(batch[i].params); // copied into libpq's output buffer on send
+            if (!unprepared[i].text.empty() && !names[i].empty()) {
+                sent = PQsendPrepare(pg, names[i].c_str(), unprepared[i].text.c_str(), params.count(), params.types())
+                    == 1;
+                if (!sent) break;
+                steps.emplace_back(Step::Prepare, i);
+            }
+            if (names[i].empty()) {
+                sent = PQsendQueryParams(
+                           pg,
+                           unprepared[i].text.c_str(),
+                           params.count(),
+                           params.types(),
+                           params.values(),
+                           params.lengths(),
+                           params.formats(),
+                           kTextFormat
+                       )
+                    == 1;
+            } else {
+                sent = PQsendQueryPrepared(
+                           pg,
+                           names[i].c_str(),
+                           params.count(),
+                           params.values(),
+                           params.lengths(),
+                           params.formats(),
+                           kTextFormat
+                       )
+                    == 1;
+            }
+            if (sent) steps.emplace_back(Step::Query, i);
+        }
+        if (sent && ownTxn) {
+            sent = sendCommand("COMMIT");
+            if (sent) steps.emplace_back(Step::Commit, 0);
+        }
+
+        // The first failure is kept and thrown once the pipeline is drained; after a server error
+        // the remaining commands come back as PGRES_PIPELINE_ABORTED.
+        std::exception_ptr error;
+        if (!sent) error = std::make_exception_ptr(makeError(conn, nullptr));
+        if (PQpipelineSync(pg) != 1) {
+            const auto lost = makeError(conn, nullptr);
+            reset(conn);
+            throw lost;
+        }
+        if (!batch.empty()) phases.front().prepare = clock.lap();
+
+        bool inSync = true;
+        for (const auto& [step, index] : steps) {
+            const ResultPtr result(PQgetResult(pg));
+            if (!result) {
+                if (!error) error = std::make_exception_ptr(makeError(conn, nullptr));
+                inSync = false;
+                break;
+            }
+            PQclear(PQgetResult(pg)); // the null that ends each command's results
+            if (error) continue;
+
+            const auto status = PQresultStatus(result.get());
+            if (step != Step::Query) {
+                if (status != PGRES_COMMAND_OK) {
+                    error = std::make_exception_ptr(makeError(conn, result.get()));
+                } else if (step == Step::Prepare) {
+                    conn.prepared.emplace(
+                        std::string(batch[index].sql),
+                        Prepared{.name = names[index], .paramCount = unprepared[index].paramCount}
+                    );
+                }
+                continue;
+            }
+            if (status != PGRES_TUPLES_OK) {
+                error = std::make_exception_ptr(makeError(conn, result.get()));
+                continue;
+            }
+            auto& queryPhases = phases[index];
+            queryPhases.step  = clock.lap();
+            try {
+                ResultRowView row(result.get());
+                for (int i = 0; i < PQntuples(result.get()); ++i) {
+                    row.seek(i);
+                    batch[index].fn(row);
+                }
+            } catch (...) {
+                error = std::current_exception();
+            }
+            queryPhases.extract = clock.lap();
+            queryPhases.rows    = static_cast<std::uint64_t>(PQntuples(result.get()));
+        }
+        if (inSync) {
+            const ResultPtr sync(PQgetResult(pg));
+            inSync = PQresultStatus(sync.get()) == PGRES_PIPELINE_SYNC && PQexitPipelineMode(pg) == 1;
+        }
+        if (!inSync) {
+            // Results can no longer be matched to commands; start over with a new session.
+            reset(conn);
+        } else if (ownTxn && PQtransactionStatus(pg) != PQTRANS_IDLE) {
+            // A failed command leaves the batch's transaction open and aborted.
+            PQclear(PQexec(pg, "ROLLBACK"));
+        }
+        if (error) std::rethrow_exception(error);
+
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            finishStatement(conn, batch[i].sql, phases[i]);
+        }
+    });
+}
+
+void PostgreSQLDatabase::withTransaction(const std::function<void()>& fn) {
+    const auto      scope = calls_.scope(DbCall::Transaction);
+    std::lock_guard lock(writerMutex_);
+    PGconn*         pg = writer_->pg.get();
+    if (txnOwner_.load(std::memory_order_acquire) == std::this_thread::get_id()) {
+        fn(); // nested: commits or rolls back with the outer transaction
+        return;
+    }
+    // Route this thread's reads to the writer for the duration of the transaction.
+    const auto previousOwner = txnOwner_.exchange(std::this_thread::get_id(), std::memory_order_acq_rel);
+    try {
+        check(*writer_, ResultPtr(PQexec(pg, "BEGIN")).get(), PGRES_COMMAND_OK);
+        fn();
+        const ResultPtr commit(PQexec(pg, "COMMIT"));
+        check(*writer_, commit.get(), PGRES_COMMAND_OK);
+        // COMMIT of a transaction aborted by an error that `fn` caught succeeds as a rollback.
+        if (std::string_view(PQcmdStatus(commit.get())) == "ROLLBACK") {
+            throw DatabaseException(DbErrorCode::QueryFailed, "Transaction was rolled back after an earlier error");
+        }
+    } catch (...) {
+        PQclear(PQexec(pg, "ROLLBACK")); // only a warning if the transaction already ended
+        txnOwner_.store(previousOwner, std::memory_order_release);
+        throw;
+    }
+    txnOwner_.store(previousOwner, std::memory_order_release);
+}
+
+auto PostgreSQLDatabase::run(
+    Connection&            conn,
+    const std::string_view sql,
+    const ParamSpan        params,
+    StatementPhases&       phases,
+    PhaseClock&            clock
+) -> ResultPtr {
+    PGconn*           pg = conn.pg.get();
+    const BoundParams bound(params);
+    auto              it = conn.prepared.find(sql);
+    if (it != conn.prepared.end()) {
+        conn.hits.fetch_add(1, std::memory_order_relaxed);
+        checkParamCount(it->second.paramCount, params);
+    } else {
+        conn.misses.fetch_add(1, std::memory_order_relaxed);
+        const auto positional = toPositional(sql);
+        checkParamCount(positional.paramCount, params);
+        if (conn.prepared.size() >= options_.statementCacheSize) {
+            phases.prepare = clock.lap();
+            ResultPtr result(PQexecParams(
+                pg,
+                positional.text.c_str(),
+                bound.count(),
+                bound.types(),
+                bound.values(),
+                bound.lengths(),
+                bound.formats(),
+                kTextFormat
+            ));
+            phases.step = clock.lap();
+            return result;
+        }
+        auto name = std::format("s{}", conn.nextStatementId++);
+        check(
+            conn,
+            ResultPtr(PQprepare(pg, name.c_str(), positional.text.c_str(), bound.count(), bound.types())).get(),
+            PGRES_COMMAND_OK
+        );
+        const Prepared prepared{.name = std::move(name), .paramCount = positional.paramCount};
+        it = conn.prepared.emplace(std::string(sql), prepared).first;
+    }
+    phases.prepare = clock.lap();
+    ResultPtr result(PQexecPrepared(
+        pg,
+        it->second.name.c_str(),
+        bound.count(),
+        bound.values(),
+        bound.lengths(),
+        bound.formats(),
+        kTextFormat
+    ));
+    phases.step = clock.lap();
+    return result;
+}
+
+auto PostgreSQLDatabase::makeError(const Connection& conn, const PGresult* result) -> DatabaseException {
+    if (PQstatus(conn.pg.get()) == CONNECTION_BAD) {
+        return DatabaseException(DbErrorCode::ConnectionFailed, trimmed(PQerrorMessage(conn.pg.get())));
+    }
+    auto message = trimmed(result ? PQresultErrorMessage(result) : nullptr);
+    if (message.empty()) message = trimmed(PQerrorMessage(conn.pg.get()));
+    // SQLSTATE class 23: integrity constraint violation.
+    const char* state = result ? PQresultErrorField(result, PG_DIAG_SQLSTATE) : nullptr;
+    const auto  code  = state && std::string_view(state).starts_with("23") ? DbErrorCode::ConstraintViolation
+                                                                            : DbErrorCode::QueryFailed;
+    return DatabaseException(code, message);
+}
+
+void PostgreSQLDatabase::check(Connection& conn, const PGresult* result, const ExecStatusType expected) {
+    if (PQresultStatus(result) != expected) fail(conn, result);
+}
+
+void PostgreSQLDatabase::fail(Connection& conn, const PGresult* result) {
+    auto error = makeError(conn, result);
+    if (PQstatus(conn.pg.get()) == CONNECTION_BAD) reset(conn);
+    throw error;
+}
+
+void PostgreSQLDatabase::reset(Connection& conn) {
+    PQreset(conn.pg.get());
+    conn.prepared.clear();
+}
+
+void PostgreSQLDatabase::collectMetrics(utils::metrics::MetricVisitor& visitor) {
+    calls_.collect(visitor);
+    std::uint64_t hits     = 0;
+    std::uint64_t misses   = 0;
+    std::size_t   prepared = 0;
+    const auto    accumulate = [&](const Connection& conn) {
+        hits     += conn.hits.load(std::memory_order_relaxed);
+        misses   += conn.misses.load(std::memory_order_relaxed);
+        prepared += conn.prepared.size();
+    };
+    {
+        std::lock_guard lock(writerMutex_);
+        accumulate(*writer_);
+    }
+    {
+        // Idle readers can be inspected without leasing them; busy ones report on their next idle period.
+        std::lock_guard lock(poolMutex_);
+        for (const auto* reader : idleReaders_) {
+            accumulate(*reader);
+        }
+    }
+    visitor.counter("bakaperms_sql_statement_cache_hits_total", "Statements reused from the cache.", {}, hits);
+    visitor.counter("bakaperms_sql_statement_cache_misses_total", "Statements prepared on a miss.", {}, misses);
+    visitor.gauge(
+        "bakaperms_sql_statement_cache_size",
+        "Prepared statements held by idle connections.",
+        {},
+        static_cast<double>(prepared)
+    );
+}
+
+auto PostgreSQLDatabase::getStatementProfiles() -> std::vector<StatementProfile> { return profiler_.profiles(); }
+
+void PostgreSQLDatabase::finishStatement(
+    Connection&            conn,
+    const std::string_view sql,
+    const StatementPhases& phases
+) {
+    profiler_.record(sql, phases);
+
+    const auto suppressed = slowQueries_.admit(phases.total());
+    if (!suppressed || !options_.onSlowQuery) return;
+    options_.onSlowQuery({
+        .sql        = sql,
+        .phases     = phases,
+        .plan       = explainQueryPlan(conn, sql),
+        .suppressed = *suppressed,
+    });
+}
+
+auto PostgreSQLDatabase::explainQueryPlan(Connection& conn, const std::string_view sql) -> std::string {
+    // EXPLAIN would plan only the first of several statements and run the others.
+    if (sql.find(';') != std::string_view::npos) return {};
+    PGconn*    pg    = conn.pg.get();
+    const auto state = PQtransactionStatus(pg);
+    if (state != PQTRANS_IDLE && state != PQTRANS_INTRANS) return {};
+
+    // A failed EXPLAIN must not abort the caller's transaction, so it runs in a savepoint there.
+    const bool inTxn = state == PQTRANS_INTRANS;
+    if (inTxn) PQclear(PQexec(pg, "SAVEPOINT bakaperms_explain"));
+    // GENERIC_PLAN (PostgreSQL 16 and later) plans the statement without parameter values; older
+    // servers reject it and the report goes out without a plan.
+    const ResultPtr explain(PQexec(pg, std::format("EXPLAIN (GENERIC_PLAN) {}", toPositional(sql).text).c_str()));
+    const bool      planned = PQresultStatus(explain.get()) == PGRES_TUPLES_OK;
+    if (inTxn) {
+        PQclear(PQexec(pg, planned ? "RELEASE SAVEPOINT bakaperms_explain"
+                                   : "ROLLBACK TO SAVEPOINT bakaperms_explain"));
+    }
+    if (!planned) return {};
+
+    // One row per plan line, already indented by depth.
+    std::string plan;
+    for (int i = 0; i < PQntuples(explain.get()); ++i) {
+        if (!plan.empty()) plan += '\n';
+        plan += PQgetvalue(explain.get(), i, 0);
+    }
+    return plan;
+}
+
+} // namespace BakaPerms::database
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "BakaPerms/Database/CallMetrics.hpp"
+#include "BakaPerms/Database/DatabaseException.hpp"
+#include "BakaPerms/Database/IDatabase.hpp"
+#include "BakaPerms/Database/StatementProfiler.hpp"
+
+#include <libpq-fe.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace BakaPerms::database {
+
+struct PostgreSQLOptions {
+    std::string host{"localhost"};
+    int         port{5432};
+    std::string user{"postgres"};
+    std::string password;
+    std::string database{"baka_perms"};
+    std::string sslMode{"prefer"}; // libpq sslmode: disable, prefer, require, verify-full, ...
+    int         connectTimeoutSeconds{10};
+
+    std::size_t statementCacheSize{64};   // server-side prepared statements kept per connection
+    std::size_t readConnections{4};       // 0 routes reads through the writer connection
+    std::size_t profiledStatements{1024}; // distinct SQL texts timed for getStatementProfiles()
+
+    std::chrono::milliseconds slowQueryThreshold{0}; // 0 disables slow-query reports
+    std::chrono::seconds      slowQueryInterval{10}; // at most one report per interval
+    // Called on the thread that ran the statement, while it still holds the connection: it must not
+    // use this database.
+    std::function<void(const SlowQueryReport&)> onSlowQuery;
+};
+
+/// IDatabase over libpq. SQL is written with '?' placeholders, as for SQLite, and rewritten to
+/// $1, $2, ... once per statement; each connection keeps its statements prepared on the server.
+/// Results are received whole, so forEachRow() saves the Row copies but not the transfer.
+class PostgreSQLDatabase final : public IDatabase {
+public:
+    explicit PostgreSQLDatabase(const PostgreSQLOptions& options);
+    ~PostgreSQLDatabase() override;
+
+    using IDatabase::execute;
+    using IDatabase::exists;
+    using IDatabase::forEachRow;
+    using IDatabase::query;
+    using IDatabase::queryOne;
+
+    /// DDL and DML always run on the single writer connection.
+    void exec(std::string_view sql) override;
+    auto execute(std::string_view sql, ParamSpan params) -> int override;
+
+    /// Reads run on a pooled read-only connection, unless the calling thread is inside
+    /// withTransaction(), in which case they go to the writer so they see uncommitted changes.
+    auto query(std::string_view sql, ParamSpan params) -> ResultSet override;
+    auto queryOne(std::string_view sql, ParamSpan params) -> std::optional<Row> override;
+    bool exists(std::string_view sql, ParamSpan params) override;
+    void forEachRow(std::string_view sql, ParamSpan params, const std::function<void(const RowView&)>& fn) override;
+    /// Sends every query in one pipeline inside a READ ONLY REPEATABLE READ transaction, or inside
+    /// the caller's transaction, and waits for the server once.
+    void forEachRowBatch(std::span<const BatchQuery> batch) override;
+    void withTransaction(const std::function<void()>& fn) override;
+
+    /// Per-entry-point latency and failure counts, plus the prepared statement counters.
+    void collectMetrics(utils::metrics::MetricVisitor& visitor) override;
+
+    /// Lock wait, prepare, execution and row extraction time of each SQL text, most total time first.
+    auto getStatementProfiles() -> std::vector<StatementProfile> override;
+
+private:
+    struct ConnDeleter {
+        void operator()(PGconn* conn) const { PQfinish(conn); }
+    };
+    struct ResultDeleter {
+        void operator()(PGresult* result) const { PQclear(result); }
+    };
+    using ResultPtr = std::unique_ptr<PGresult, ResultDeleter>;
+
+    // Transparent lookup, so a string_view SQL text finds its prepared statement without a copy.
+    struct SqlHash {
+        using is_transparent = void;
+        auto operator()(const std::string_view sql) const noexcept -> std::size_t {
+            return std::hash<std::string_view>{}(sql);
+        }
+    };
+
+    struct Prepared {
+        std::string name;       // server-side statement name
+        std::size_t paramCount; // placeholders in the SQL text
+    };
+
+    struct Connection {
+        std::unique_ptr<PGconn, ConnDeleter> pg;
+        // Original SQL text → its server-side prepared statement. Statements live as long as the
+        // session, so the map is cleared when the connection is reset.
+        std::unordered_map<std::string, Prepared, SqlHash, std::equal_to<>> prepared;
+        std::uint64_t                                                       nextStatementId{0};
+        std::atomic<std::uint64_t>                                          hits{0};
+        std::atomic<std::uint64_t>                                          misses{0};
+    };
+
+    class ReaderLease {
+    public:
+        explicit ReaderLease(PostgreSQLDatabase& owner);
+        ~ReaderLease();
+        ReaderLease(const ReaderLease&)            = delete;
+        ReaderLease& operator=(const ReaderLease&) = delete;
+
+        [[nodiscard]] auto get() const -> Connection& { return *conn_; }
+
+    private:
+        PostgreSQLDatabase& owner_;
+        Connection*         conn_;
+    };
+
+    static auto openConnection(const PostgreSQLOptions& options, bool writer) -> std::unique_ptr<Connection>;
+
+    // Run `sql` with `params` as a prepared statement, preparing it first on a miss; once the
+    // connection holds statementCacheSize statements, further texts run unnamed.
+    auto run(Connection& conn, std::string_view sql, ParamSpan params, StatementPhases& phases, PhaseClock& clock)
+        -> ResultPtr;
+    // Error of a failed `result`, or of the connection if there is no result.
+    static auto makeError(const Connection& conn, const PGresult* result) -> DatabaseException;
+    // Throws for a result that is not `expected`, resetting the connection if it was lost.
+    static void check(Connection& conn, const PGresult* result, ExecStatusType expected);
+    [[noreturn]] static void fail(Connection& conn, const PGresult* result);
+    // Reconnect, dropping the session's prepared statements and any open transaction.
+    static void reset(Connection& conn);
+
+    // Record a successful statement in the profiler and report it if it was slow. `conn` is the
+    // connection that ran it, still held by the caller.
+    void finishStatement(Connection& conn, std::string_view sql, const StatementPhases& phases);
+    static auto explainQueryPlan(Connection& conn, std::string_view sql) -> std::string;
+
+    template <typename Fn>
+    auto withReader(Fn&& fn) -> decltype(fn(std::declval<Connection&>()));
+
+    // Writer
+    std::unique_ptr<Connection>  writer_;
+    std::recursive_mutex         writerMutex_;
+    std::atomic<std::thread::id> txnOwner_{};
+
+    // Read pool
+    std::vector<std::unique_ptr<Connection>> readers_;
+    std::vector<Connection*>                 idleReaders_;
+    std::mutex                               poolMutex_;
+    std::condition_variable                  poolCv_;
+
+    CallMetrics       calls_;
+    PostgreSQLOptions options_;
+    StatementProfiler profiler_;
+    SlowQueryGate     slowQueries_;
+};
+
+} // namespace BakaPerms::database
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "BakaPerms/Database/DbTypes.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace BakaPerms::database {
+
+/// Decodes columns [column, column + kColumns) of a RowView into a T. Specializations provide
+///   static constexpr std::size_t kColumns;
+///   static auto decode(const RowView& row, std::size_t column) -> T;
+/// Structs are usually declared as a MemberDecoder over their fields.
+template <typename T>
+struct RowDecoder;
+
+template <>
+struct RowDecoder<int> {
+    static constexpr std::size_t kColumns = 1;
+    static auto decode(const RowView& row, const std::size_t column) -> int { return row.getInt(column); }
+};
+
+template <>
+struct RowDecoder<std::int64_t> {
+    static constexpr std::size_t kColumns = 1;
+    static auto decode(const RowView& row, const std::size_t column) -> std::int64_t { return row.getInt64(column); }
+};
+
+template <>
+struct RowDecoder<double> {
+    static constexpr std::size_t kColumns = 1;
+    static auto decode(const RowView& row, const std::size_t column) -> double { return row.getDouble(column); }
+};
+
+template <>
+struct RowDecoder<std::string> {
+    static constexpr std::size_t kColumns = 1;
+    static auto decode(const RowView& row, const std::size_t column) -> std::string {
+        return std::string(row.getText(column));
+    }
+};
+
+template <typename T>
+    requires(RowDecoder<T>::kColumns == 1)
+struct RowDecoder<std::optional<T>> {
+    static constexpr std::size_t kColumns = 1;
+    static auto decode(const RowView& row, const std::size_t column) -> std::optional<T> {
+        if (row.isNull(column)) return std::nullopt;
+        return RowDecoder<T>::decode(row, column);
+    }
+};
+
+namespace detail {
+
+template <auto Member>
+struct MemberTraits;
+
+template <typename Class, typename Field, Field Class::* Member>
+struct MemberTraits<Member> {
+    using ClassType = Class;
+    using FieldType = Field;
+};
+
+template <auto Member>
+using FieldDecoder = RowDecoder<typename MemberTraits<Member>::FieldType>;
+
+} // namespace detail
+
+/// Decoder for an aggregate whose fields map, in order, to consecutive columns:
+///   template <> struct RowDecoder<Point> : MemberDecoder<&Point::x, &Point::y> {};
+/// Nested structs take as many columns as their own decoder.
+template <auto First, auto... Rest>
+struct MemberDecoder {
+    using Type = typename detail::MemberTraits<First>::ClassType;
+
+    static constexpr std::size_t kColumns =
+        (detail::FieldDecoder<First>::kColumns + ... + detail::FieldDecoder<Rest>::kColumns);
+
+    static auto decode(const RowView& row, std::size_t column) -> Type {
+        Type value{};
+        decodeInto<First, Rest...>(value, row, column);
+        return value;
+    }
+
+private:
+    template <auto... Members>
+    static void decodeInto(Type& value, const RowView& row, std::size_t column) {
+        ((value.*Members = detail::FieldDecoder<Members>::decode(row, column),
+          column += detail::FieldDecoder<Members>::kColumns),
+         ...);
+    }
+};
+
+} // namespace BakaPerms::database
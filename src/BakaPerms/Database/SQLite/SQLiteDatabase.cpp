@@ -4,6 +4,10 @@
 
 #include <SQLiteCpp/Database.h>
 #include <SQLiteCpp/Statement.h>
+#include <sqlite3.h>
+
+#include <format>
+#include <unordered_map>
 
 constexpr int kSqliteInteger = 1;
 constexpr int kSqliteFloat   = 2;
@@ -13,33 +17,143 @@ constexpr int kSqliteNull    = 5;
 
 namespace BakaPerms::database {
 
-SQLiteDatabase::SQLiteDatabase(const std::filesystem::path& dbPath) {
+namespace {
+
+// Current step of a statement; columns are read from SQLite's own buffers without copying.
+class StatementRowView final : public RowView {
+public:
+    explicit StatementRowView(const SQLite::Statement& stmt) : stmt_(stmt) {}
+
+    [[nodiscard]] auto columnCount() const -> std::size_t override {
+        return static_cast<std::size_t>(stmt_.getColumnCount());
+    }
+    [[nodiscard]] bool isNull(const std::size_t index) const override { return column(index).isNull(); }
+    [[nodiscard]] auto getInt(const std::size_t index) const -> int override { return column(index).getInt(); }
+    [[nodiscard]] auto getInt64(const std::size_t index) const -> std::int64_t override {
+        return column(index).getInt64();
+    }
+    [[nodiscard]] auto getDouble(const std::size_t index) const -> double override {
+        return column(index).getDouble();
+    }
+    [[nodiscard]] auto getText(const std::size_t index) const -> std::string_view override {
+        const auto  col  = column(index);
+        const char* text = col.getText(); // must precede getBytes() so the size is that of the UTF-8 text
+        return {text, static_cast<std::size_t>(col.getBytes())};
+    }
+
+private:
+    [[nodiscard]] auto column(const std::size_t index) const -> SQLite::Column {
+        return stmt_.getColumn(static_cast<int>(index));
+    }
+
+    const SQLite::Statement& stmt_;
+};
+
+} // namespace
+
+SQLiteDatabase::SQLiteDatabase(const std::filesystem::path& dbPath, const SQLiteOptions& options)
+: options_(options),
+  profiler_(options.profiledStatements),
+  slowQueries_(options.slowQueryThreshold, options.slowQueryInterval) {
     try {
-        db_ = std::make_unique<SQLite::Database>(dbPath.string(), SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
-        db_->exec("PRAGMA journal_mode=WAL");
-        db_->exec("PRAGMA foreign_keys=ON");
+        writer_ = openConnection(dbPath, options, true);
+        // Readers are opened after the writer so the file and WAL mode already exist.
+        readers_.reserve(options.readConnections);
+        idleReaders_.reserve(options.readConnections);
+        for (std::size_t i = 0; i < options.readConnections; ++i) {
+            readers_.push_back(openConnection(dbPath, options, false));
+            idleReaders_.push_back(readers_.back().get());
+        }
     } catch (const SQLite::Exception& e) {
         throw DatabaseException(DbErrorCode::ConnectionFailed, e.what());
     }
 }
 
-SQLiteDatabase::~SQLiteDatabase() = default;
+SQLiteDatabase::~SQLiteDatabase() {
+    // Prepared statements must be finalized before their connection is closed.
+    std::lock_guard lock(writerMutex_);
+    for (const auto& reader : readers_) {
+        reader->statements.reset();
+    }
+    writer_->statements.reset();
+}
+
+auto SQLiteDatabase::openConnection(
+    const std::filesystem::path& dbPath,
+    const SQLiteOptions&         options,
+    const bool                   writer
+) -> std::unique_ptr<Connection> {
+    auto conn = std::make_unique<Connection>();
+    conn->db  = std::make_unique<SQLite::Database>(
+        dbPath.string(),
+        SQLite::OPEN_READWRITE | (writer ? SQLite::OPEN_CREATE : 0),
+        options.busyTimeoutMs
+    );
+    if (writer) {
+        conn->db->exec("PRAGMA journal_mode=WAL");
+        conn->db->exec("PRAGMA foreign_keys=ON");
+    } else {
+        // Opened read-write so WAL shared memory is usable, but rejects any write.
+        conn->db->exec("PRAGMA query_only=ON");
+    }
+    conn->statements = std::make_unique<StatementCache>(*conn->db, options.statementCacheSize);
+    return conn;
+}
+
+SQLiteDatabase::ReaderLease::ReaderLease(SQLiteDatabase& owner) : owner_(owner) {
+    std::unique_lock lock(owner_.poolMutex_);
+    owner_.poolCv_.wait(lock, [this] { return !owner_.idleReaders_.empty(); });
+    conn_ = owner_.idleReaders_.back();
+    owner_.idleReaders_.pop_back();
+}
+
+SQLiteDatabase::ReaderLease::~ReaderLease() {
+    {
+        std::lock_guard lock(owner_.poolMutex_);
+        owner_.idleReaders_.push_back(conn_);
+    }
+    owner_.poolCv_.notify_one();
+}
+
+template <typename Fn>
+auto SQLiteDatabase::withReader(Fn&& fn) -> decltype(fn(std::declval<Connection&>())) {
+    if (readers_.empty() || txnOwner_.load(std::memory_order_acquire) == std::this_thread::get_id()) {
+        std::lock_guard lock(writerMutex_);
+        return fn(*writer_);
+    }
+    const ReaderLease lease(*this);
+    return fn(lease.get());
+}
 
 void SQLiteDatabase::exec(const std::string_view sql) {
-    std::lock_guard lock(mutex_);
+    const auto      scope = calls_.scope(DbCall::Exec);
+    PhaseClock      clock;
+    StatementPhases phases;
+    std::lock_guard lock(writerMutex_);
+    phases.lockWait = clock.lap();
     try {
-        db_->exec(std::string(sql));
+        writer_->db->exec(std::string(sql));
     } catch (const SQLite::Exception& e) {
         throw DatabaseException(DbErrorCode::QueryFailed, e.what());
     }
+    phases.step = clock.lap();
+    finishStatement(*writer_, sql, phases);
 }
 
-int SQLiteDatabase::execute(const std::string_view sql, const ParamList& params) {
-    std::lock_guard lock(mutex_);
+int SQLiteDatabase::execute(const std::string_view sql, const ParamSpan params) {
+    const auto      scope = calls_.scope(DbCall::Execute);
+    PhaseClock      clock;
+    StatementPhases phases;
+    std::lock_guard lock(writerMutex_);
+    phases.lockWait = clock.lap();
     try {
-        SQLite::Statement stmt(*db_, std::string(sql));
-        bindParams(stmt, params);
-        return stmt.exec();
+        const auto stmt = writer_->statements->acquire(sql);
+        bindParams(*stmt, params);
+        phases.prepare     = clock.lap();
+        const auto changes = stmt->exec();
+        phases.step        = clock.lap();
+        finishStatement(*writer_, sql, phases);
+        return changes;
     } catch (const DatabaseException&) {
         throw;
     } catch (const SQLite::Exception& e) {
@@ -47,45 +161,148 @@ int SQLiteDatabase::execute(const std::string_view sql, const ParamList& params)
     }
 }
 
-ResultSet SQLiteDatabase::query(const std::string_view sql, const ParamList& params) {
-    std::lock_guard lock(mutex_);
-    try {
-        SQLite::Statement stmt(*db_, std::string(sql));
-        bindParams(stmt, params);
-        ResultSet results;
-        while (stmt.executeStep()) {
-            results.push_back(extractRow(stmt));
+ResultSet SQLiteDatabase::query(const std::string_view sql, const ParamSpan params) {
+    const auto scope = calls_.scope(DbCall::Query);
+    PhaseClock clock;
+    return withReader([&](const Connection& conn) {
+        StatementPhases phases;
+        phases.lockWait = clock.lap();
+        try {
+            const auto stmt = conn.statements->acquire(sql);
+            bindParams(*stmt, params);
+            phases.prepare = clock.lap();
+            ResultSet results;
+            while (stmt->executeStep()) {
+                phases.step += clock.lap();
+                results.push_back(extractRow(*stmt));
+                phases.extract += clock.lap();
+            }
+            phases.step += clock.lap();
+            phases.rows  = results.size();
+            finishStatement(conn, sql, phases);
+            return results;
+        } catch (const DatabaseException&) {
+            throw;
+        } catch (const SQLite::Exception& e) {
+            throw DatabaseException(DbErrorCode::QueryFailed, e.what());
         }
-        return results;
-    } catch (const DatabaseException&) {
-        throw;
-    } catch (const SQLite::Exception& e) {
-        throw DatabaseException(DbErrorCode::QueryFailed, e.what());
-    }
+    });
 }
 
-std::optional<Row> SQLiteDatabase::queryOne(const std::string_view sql, const ParamList& params) {
-    std::lock_guard lock(mutex_);
-    try {
-        SQLite::Statement stmt(*db_, std::string(sql));
-        bindParams(stmt, params);
-        if (stmt.executeStep()) {
-            return extractRow(stmt);
+std::optional<Row> SQLiteDatabase::queryOne(const std::string_view sql, const ParamSpan params) {
+    const auto scope = calls_.scope(DbCall::QueryOne);
+    PhaseClock clock;
+    return withReader([&](const Connection& conn) -> std::optional<Row> {
+        StatementPhases phases;
+        phases.lockWait = clock.lap();
+        try {
+            const auto stmt = conn.statements->acquire(sql);
+            bindParams(*stmt, params);
+            phases.prepare = clock.lap();
+            std::optional<Row> row;
+            if (stmt->executeStep()) {
+                phases.step    = clock.lap();
+                row            = extractRow(*stmt);
+                phases.extract = clock.lap();
+                phases.rows    = 1;
+            } else {
+                phases.step = clock.lap();
+            }
+            finishStatement(conn, sql, phases);
+            return row;
+        } catch (const DatabaseException&) {
+            throw;
+        } catch (const SQLite::Exception& e) {
+            throw DatabaseException(DbErrorCode::QueryFailed, e.what());
         }
-        return std::nullopt;
-    } catch (const DatabaseException&) {
-        throw;
-    } catch (const SQLite::Exception& e) {
-        throw DatabaseException(DbErrorCode::QueryFailed, e.what());
-    }
+    });
+}
+
+bool SQLiteDatabase::exists(const std::string_view sql, const ParamSpan params) {
+    const auto scope = calls_.scope(DbCall::Exists);
+    PhaseClock clock;
+    return withReader([&](const Connection& conn) {
+        StatementPhases phases;
+        phases.lockWait = clock.lap();
+        try {
+            const auto stmt = conn.statements->acquire(sql);
+            bindParams(*stmt, params);
+            phases.prepare   = clock.lap();
+            const bool found = stmt->executeStep();
+            phases.step      = clock.lap();
+            phases.rows      = found ? 1 : 0;
+            finishStatement(conn, sql, phases);
+            return found;
+        } catch (const DatabaseException&) {
+            throw;
+        } catch (const SQLite::Exception& e) {
+            throw DatabaseException(DbErrorCode::QueryFailed, e.what());
+        }
+    });
 }
 
-bool SQLiteDatabase::exists(const std::string_view sql, const ParamList& params) {
-    std::lock_guard lock(mutex_);
+void SQLiteDatabase::forEachRow(
+    const std::string_view                     sql,
+    const ParamSpan                            params,
+    const std::function<void(const RowView&)>& fn
+) {
+    const auto scope = calls_.scope(DbCall::ForEachRow);
+    PhaseClock clock;
+    withReader([&](const Connection& conn) { stepRows(conn, sql, params, fn, clock); });
+}
+
+void SQLiteDatabase::forEachRowBatch(const std::span<const BatchQuery> batch) {
+    const auto scope = calls_.scope(DbCall::Batch);
+    PhaseClock clock;
+    withReader([&](const Connection& conn) {
+        // In autocommit mode every statement would read its own snapshot of the WAL; one read
+        // transaction makes the whole batch see the same state. Inside withTransaction() the
+        // writer's transaction already does.
+        const bool ownTxn = sqlite3_get_autocommit(conn.db->getHandle()) != 0;
+        const auto rollback = [&conn, ownTxn] {
+            if (!ownTxn) return;
+            try {
+                conn.db->exec("ROLLBACK");
+            } catch (...) {}
+        };
+        try {
+            if (ownTxn) conn.db->exec("BEGIN");
+            for (const auto& query : batch) {
+                stepRows(conn, query.sql, query.params, query.fn, clock);
+            }
+            if (ownTxn) conn.db->exec("COMMIT");
+        } catch (const SQLite::Exception& e) {
+            rollback();
+            throw DatabaseException(DbErrorCode::QueryFailed, e.what());
+        } catch (...) {
+            rollback();
+            throw;
+        }
+    });
+}
+
+void SQLiteDatabase::stepRows(
+    const Connection&                          conn,
+    const std::string_view                     sql,
+    const ParamSpan                            params,
+    const std::function<void(const RowView&)>& fn,
+    PhaseClock&                                clock
+) {
+    StatementPhases phases;
+    phases.lockWait = clock.lap();
     try {
-        SQLite::Statement stmt(*db_, std::string(sql));
-        bindParams(stmt, params);
-        return stmt.executeStep();
+        const auto             stmt = conn.statements->acquire(sql);
+        const StatementRowView row(*stmt);
+        bindParams(*stmt, params);
+        phases.prepare = clock.lap();
+        while (stmt->executeStep()) {
+            phases.step += clock.lap();
+            fn(row);
+            phases.extract += clock.lap();
+            ++phases.rows;
+        }
+        phases.step += clock.lap();
+        finishStatement(conn, sql, phases);
     } catch (const DatabaseException&) {
         throw;
     } catch (const SQLite::Exception& e) {
@@ -94,20 +311,108 @@ bool SQLiteDatabase::exists(const std::string_view sql, const ParamList& params)
 }
 
 void SQLiteDatabase::withTransaction(const std::function<void()>& fn) {
-    std::lock_guard lock(mutex_);
+    const auto      scope = calls_.scope(DbCall::Transaction);
+    std::lock_guard lock(writerMutex_);
+    if (txnOwner_.load(std::memory_order_acquire) == std::this_thread::get_id()) {
+        fn(); // nested: commits or rolls back with the outer transaction
+        return;
+    }
+    // Route this thread's reads to the writer for the duration of the transaction.
+    const auto previousOwner = txnOwner_.exchange(std::this_thread::get_id(), std::memory_order_acq_rel);
     try {
-        db_->exec("BEGIN TRANSACTION");
+        writer_->db->exec("BEGIN TRANSACTION");
         fn();
-        db_->exec("COMMIT");
+        writer_->db->exec("COMMIT");
     } catch (...) {
         try {
-            db_->exec("ROLLBACK");
+            writer_->db->exec("ROLLBACK");
         } catch (...) {}
+        txnOwner_.store(previousOwner, std::memory_order_release);
         throw;
     }
+    txnOwner_.store(previousOwner, std::memory_order_release);
 }
 
-void SQLiteDatabase::bindParams(SQLite::Statement& stmt, const ParamList& params) {
+auto SQLiteDatabase::getStatementCacheStats() -> StatementCacheStats {
+    StatementCacheStats total;
+    const auto          accumulate = [&total](const Connection& conn) {
+        const auto stats  = conn.statements->stats();
+        total.hits       += stats.hits;
+        total.misses     += stats.misses;
+        total.size       += stats.size;
+        total.capacity   += stats.capacity;
+    };
+    {
+        std::lock_guard lock(writerMutex_);
+        accumulate(*writer_);
+    }
+    // Idle readers can be inspected without leasing them; busy ones report on their next idle period.
+    std::lock_guard lock(poolMutex_);
+    for (const auto* reader : idleReaders_) {
+        accumulate(*reader);
+    }
+    return total;
+}
+
+void SQLiteDatabase::collectMetrics(utils::metrics::MetricVisitor& visitor) {
+    calls_.collect(visitor);
+    const auto stats = getStatementCacheStats();
+    visitor.counter("bakaperms_sql_statement_cache_hits_total", "Statements reused from the cache.", {}, stats.hits);
+    visitor.counter("bakaperms_sql_statement_cache_misses_total", "Statements prepared on a miss.", {}, stats.misses);
+    visitor.gauge(
+        "bakaperms_sql_statement_cache_size",
+        "Prepared statements held by idle connections.",
+        {},
+        static_cast<double>(stats.size)
+    );
+}
+
+auto SQLiteDatabase::getStatementProfiles() -> std::vector<StatementProfile> { return profiler_.profiles(); }
+
+void SQLiteDatabase::finishStatement(
+    const Connection&      conn,
+    const std::string_view sql,
+    const StatementPhases& phases
+) {
+    profiler_.record(sql, phases);
+
+    const auto suppressed = slowQueries_.admit(phases.total());
+    if (!suppressed || !options_.onSlowQuery) return;
+    options_.onSlowQuery({
+        .sql        = sql,
+        .phases     = phases,
+        .plan       = explainQueryPlan(conn, sql),
+        .suppressed = *suppressed,
+    });
+}
+
+auto SQLiteDatabase::explainQueryPlan(const Connection& conn, const std::string_view sql) -> std::string {
+    // Rows are (id, parent, notused, detail) in tree order; indent each step below its parent.
+    std::string                          plan;
+    std::unordered_map<int, std::size_t> depths{{0, 0}};
+    try {
+        SQLite::Statement explain(*conn.db, std::format("EXPLAIN QUERY PLAN {}", sql));
+        while (explain.executeStep()) {
+            const int  id    = explain.getColumn(0).getInt();
+            const auto depth = depths[explain.getColumn(1).getInt()];
+            depths[id]       = depth + 1;
+            if (!plan.empty()) plan += '\n';
+            plan.append(depth * 2, ' ');
+            plan += explain.getColumn(3).getString();
+        }
+    } catch (const SQLite::Exception&) {
+        return {}; // e.g. several statements in one exec() call
+    }
+    return plan;
+}
+
+void SQLiteDatabase::bindParams(SQLite::Statement& stmt, const ParamSpan params) {
+    if (const auto expected = stmt.getBindParameterCount(); params.size() != static_cast<std::size_t>(expected)) {
+        throw DatabaseException(
+            DbErrorCode::BindError,
+            std::format("Statement expects {} parameters, got {}", expected, params.size())
+        );
+    }
     for (std::size_t i = 0; i < params.size(); ++i) {
         const int idx = static_cast<int>(i) + 1;
         std::visit(
@@ -115,6 +420,17 @@ void SQLiteDatabase::bindParams(SQLite::Statement& stmt, const ParamList& params
                 using T = std::decay_t<Ty>;
                 if constexpr (std::is_same_v<T, DbNull>) {
                     stmt.bind(idx);
+                } else if constexpr (std::is_same_v<T, std::string_view>) {
+                    // SQLITE_STATIC: the view outlives the statement's use, and the lease clears
+                    // bindings on release, so SQLite never copies the text.
+                    const int rc = sqlite3_bind_text(
+                        stmt.getPreparedStatement(),
+                        idx,
+                        val.data(),
+                        static_cast<int>(val.size()),
+                        SQLITE_STATIC
+                    );
+                    if (rc != SQLITE_OK) throw DatabaseException(DbErrorCode::BindError, sqlite3_errstr(rc));
                 } else {
                     stmt.bind(idx, val);
                 }
@@ -1,34 +1,130 @@
 #pragma once
 
+#include "BakaPerms/Database/CallMetrics.hpp"
 #include "BakaPerms/Database/IDatabase.hpp"
+#include "BakaPerms/Database/SQLite/StatementCache.h"
+#include "BakaPerms/Database/StatementProfiler.hpp"
 
 #include <SQLiteCpp/Database.h>
 #include <SQLiteCpp/Statement.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
 
 namespace BakaPerms::database {
 
+struct SQLiteOptions {
+    std::size_t statementCacheSize{64};   // prepared statements kept per connection
+    std::size_t readConnections{4};       // 0 routes reads through the writer connection
+    int         busyTimeoutMs{5000};
+    std::size_t profiledStatements{1024}; // distinct SQL texts timed for getStatementProfiles()
+
+    std::chrono::milliseconds slowQueryThreshold{0}; // 0 disables slow-query reports
+    std::chrono::seconds      slowQueryInterval{10}; // at most one report per interval
+    // Called on the thread that ran the statement, while it still holds the connection: it must not
+    // use this database.
+    std::function<void(const SlowQueryReport&)> onSlowQuery;
+};
+
 class SQLiteDatabase final : public IDatabase {
 public:
-    explicit SQLiteDatabase(const std::filesystem::path& dbPath);
+    explicit SQLiteDatabase(const std::filesystem::path& dbPath, const SQLiteOptions& options = {});
     ~SQLiteDatabase() override;
 
+    using IDatabase::execute;
+    using IDatabase::exists;
+    using IDatabase::forEachRow;
+    using IDatabase::query;
+    using IDatabase::queryOne;
+
+    /// DDL and DML always run on the single writer connection.
     void exec(std::string_view sql) override;
-    auto execute(std::string_view sql, const ParamList& params) -> int override;
-    auto query(std::string_view sql, const ParamList& params) -> ResultSet override;
-    auto queryOne(std::string_view sql, const ParamList& params) -> std::optional<Row> override;
-    bool exists(std::string_view sql, const ParamList& params) override;
+    auto execute(std::string_view sql, ParamSpan params) -> int override;
+
+    /// Reads run on a pooled read-only connection, unless the calling thread is inside
+    /// withTransaction(), in which case they go to the writer so they see uncommitted changes.
+    auto query(std::string_view sql, ParamSpan params) -> ResultSet override;
+    auto queryOne(std::string_view sql, ParamSpan params) -> std::optional<Row> override;
+    bool exists(std::string_view sql, ParamSpan params) override;
+    void forEachRow(std::string_view sql, ParamSpan params, const std::function<void(const RowView&)>& fn) override;
+    /// Runs on one connection inside a single read transaction, or inside the caller's transaction.
+    void forEachRowBatch(std::span<const BatchQuery> batch) override;
     void withTransaction(const std::function<void()>& fn) override;
 
+    /// Per-entry-point latency and failure counts, plus the statement cache counters.
+    void collectMetrics(utils::metrics::MetricVisitor& visitor) override;
+
+    /// Lock wait, prepare, step and row extraction time of each SQL text, most total time first.
+    auto getStatementProfiles() -> std::vector<StatementProfile> override;
+
+    /// Statement cache counters summed over the writer and all read connections.
+    [[nodiscard]] auto getStatementCacheStats() -> StatementCacheStats;
+
 private:
-    static void bindParams(SQLite::Statement& stmt, const ParamList& params);
+    struct Connection {
+        std::unique_ptr<SQLite::Database> db;
+        std::unique_ptr<StatementCache>   statements;
+    };
+
+    class ReaderLease {
+    public:
+        explicit ReaderLease(SQLiteDatabase& owner);
+        ~ReaderLease();
+        ReaderLease(const ReaderLease&)            = delete;
+        ReaderLease& operator=(const ReaderLease&) = delete;
+
+        [[nodiscard]] auto get() const -> Connection& { return *conn_; }
+
+    private:
+        SQLiteDatabase& owner_;
+        Connection*     conn_;
+    };
+
+    static auto openConnection(const std::filesystem::path& dbPath, const SQLiteOptions& options, bool writer)
+        -> std::unique_ptr<Connection>;
+    static void bindParams(SQLite::Statement& stmt, ParamSpan params);
     static auto extractRow(const SQLite::Statement& stmt) -> Row;
 
-    std::unique_ptr<SQLite::Database> db_;
-    std::recursive_mutex              mutex_;
+    // Body of forEachRow() on a connection the caller already holds.
+    void stepRows(
+        const Connection&                          conn,
+        std::string_view                           sql,
+        ParamSpan                                  params,
+        const std::function<void(const RowView&)>& fn,
+        PhaseClock&                                clock
+    );
+
+    // Record a successful statement in the profiler and report it if it was slow. `conn` is the
+    // connection that ran it, still held by the caller.
+    void finishStatement(const Connection& conn, std::string_view sql, const StatementPhases& phases);
+    static auto explainQueryPlan(const Connection& conn, std::string_view sql) -> std::string;
+
+    template <typename Fn>
+    auto withReader(Fn&& fn) -> decltype(fn(std::declval<Connection&>()));
+
+    // Writer
+    std::unique_ptr<Connection>  writer_;
+    std::recursive_mutex         writerMutex_;
+    std::atomic<std::thread::id> txnOwner_{};
+
+    // Read pool
+    std::vector<std::unique_ptr<Connection>> readers_;
+    std::vector<Connection*>                 idleReaders_;
+    std::mutex                               poolMutex_;
+    std::condition_variable                  poolCv_;
+
+    CallMetrics       calls_;
+    SQLiteOptions     options_;
+    StatementProfiler profiler_;
+    SlowQueryGate     slowQueries_;
 };
 
 } // namespace BakaPerms::database
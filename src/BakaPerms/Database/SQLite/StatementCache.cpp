@@ -0,0 +1,75 @@
+#include "BakaPerms/Database/SQLite/StatementCache.h"
+
+namespace BakaPerms::database {
+
+StatementCache::Lease::~Lease() {
+    try {
+        stmt_->tryReset();
+        stmt_->clearBindings();
+    } catch (...) {}
+    if (entry_) entry_->busy = false;
+}
+
+StatementCache::StatementCache(SQLite::Database& db, const std::size_t capacity) : db_(db), capacity_(capacity) {}
+
+StatementCache::~StatementCache() { clear(); }
+
+auto StatementCache::acquire(const std::string_view sql) -> Lease {
+    if (const auto it = index_.find(sql); it != index_.end()) {
+        auto& entry = *it->second;
+        if (entry.busy) {
+            // The same SQL is already mid-step further up the stack; don't disturb it.
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return Lease(std::make_unique<SQLite::Statement>(db_, entry.sql));
+        }
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        lru_.splice(lru_.begin(), lru_, it->second);
+        entry.busy = true;
+        return Lease(entry);
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    std::string text{sql};
+    auto        stmt = std::make_unique<SQLite::Statement>(db_, text);
+    if (capacity_ == 0) return Lease(std::move(stmt));
+
+    lru_.push_front({std::move(text), std::move(stmt)});
+    auto& entry = lru_.front();
+    index_.emplace(entry.sql, lru_.begin());
+    entry.busy = true;
+    evictOverflow();
+    return Lease(entry);
+}
+
+void StatementCache::clear() {
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        if (it->busy) {
+            ++it;
+            continue;
+        }
+        index_.erase(it->sql);
+        it = lru_.erase(it);
+    }
+}
+
+auto StatementCache::stats() const -> StatementCacheStats {
+    return {
+        .hits     = hits_.load(std::memory_order_relaxed),
+        .misses   = misses_.load(std::memory_order_relaxed),
+        .size     = lru_.size(),
+        .capacity = capacity_,
+    };
+}
+
+void StatementCache::evictOverflow() {
+    // Walk from the least recently used end; leased statements are skipped and evicted on a later call.
+    auto it = lru_.end();
+    while (lru_.size() > capacity_ && it != lru_.begin()) {
+        --it;
+        if (it->busy) continue;
+        index_.erase(it->sql);
+        it = lru_.erase(it);
+    }
+}
+
+} // namespace BakaPerms::database
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <SQLiteCpp/Database.h>
+#include <SQLiteCpp/Statement.h>
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace BakaPerms::database {
+
+struct StatementCacheStats {
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+    std::size_t   size{0};
+    std::size_t   capacity{0};
+};
+
+/// Bounded LRU cache of prepared statements for a single connection, keyed by SQL text.
+/// Not thread-safe: callers must hold the owning connection's lock.
+class StatementCache {
+    struct Entry {
+        std::string                        sql;
+        std::unique_ptr<SQLite::Statement> stmt;
+        bool                               busy{false};
+    };
+    using EntryList = std::list<Entry>;
+
+public:
+    /// RAII handle to a prepared statement. On release the statement is reset and its
+    /// bindings cleared, so it never holds a read transaction open while idle.
+    class Lease {
+    public:
+        Lease(const Lease&)            = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        [[nodiscard]] auto operator*() const -> SQLite::Statement& { return *stmt_; }
+        [[nodiscard]] auto operator->() const -> SQLite::Statement* { return stmt_; }
+
+    private:
+        friend class StatementCache;
+        explicit Lease(Entry& entry) : stmt_(entry.stmt.get()), entry_(&entry) {}
+        explicit Lease(std::unique_ptr<SQLite::Statement> owned) : stmt_(owned.get()), owned_(std::move(owned)) {}
+
+        SQLite::Statement*                 stmt_;
+        Entry*                             entry_{nullptr};
+        std::unique_ptr<SQLite::Statement> owned_;
+    };
+
+    StatementCache(SQLite::Database& db, std::size_t capacity);
+    ~StatementCache();
+    StatementCache(const StatementCache&)            = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    /// Return a statement for `sql`, preparing and caching it on a miss.
+    /// If the cached statement is already leased (re-entrant use), a one-off statement is prepared instead.
+    [[nodiscard]] auto acquire(std::string_view sql) -> Lease;
+
+    /// Finalize every idle cached statement.
+    void clear();
+
+    [[nodiscard]] auto stats() const -> StatementCacheStats;
+
+private:
+    void evictOverflow();
+
+    SQLite::Database&                                         db_;
+    std::size_t                                               capacity_;
+    EntryList                                                 lru_;   // front = most recently used
+    std::unordered_map<std::string_view, EntryList::iterator> index_; // keys view into Entry::sql
+    std::atomic<std::uint64_t>                                hits_{0};
+    std::atomic<std::uint64_t>                                misses_{0};
+};
+
+} // namespace BakaPerms::database
@@ -0,0 +1,47 @@
+#include "BakaPerms/Database/StatementProfiler.hpp"
+
+#include <algorithm>
+#include <ranges>
+
+namespace BakaPerms::database {
+
+void StatementProfiler::record(const std::string_view sql, const StatementPhases& phases) {
+    std::lock_guard lock(mutex_);
+    auto            it = profiles_.find(sql);
+    if (it == profiles_.end()) {
+        if (profiles_.size() >= capacity_) return;
+        it             = profiles_.emplace(std::string(sql), StatementProfile{}).first;
+        it->second.sql = it->first;
+    }
+    auto& profile    = it->second;
+    profile.calls   += 1;
+    profile.totals  += phases;
+    profile.slowest  = std::max(profile.slowest, phases.total());
+}
+
+auto StatementProfiler::profiles() const -> std::vector<StatementProfile> {
+    std::vector<StatementProfile> result;
+    {
+        std::lock_guard lock(mutex_);
+        result.reserve(profiles_.size());
+        for (const auto& profile : profiles_ | std::views::values) {
+            result.push_back(profile);
+        }
+    }
+    std::ranges::sort(result, std::ranges::greater{}, [](const StatementProfile& p) { return p.totals.total(); });
+    return result;
+}
+
+auto SlowQueryGate::admit(const std::chrono::nanoseconds elapsed) -> std::optional<std::uint64_t> {
+    if (threshold_ <= std::chrono::milliseconds::zero() || elapsed < threshold_) return std::nullopt;
+
+    const auto now  = Clock::now().time_since_epoch().count();
+    auto       next = nextReport_.load(std::memory_order_relaxed);
+    if (now < next || !nextReport_.compare_exchange_strong(next, now + interval_, std::memory_order_relaxed)) {
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    return suppressed_.exchange(0, std::memory_order_relaxed);
+}
+
+} // namespace BakaPerms::database
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "BakaPerms/Database/DbTypes.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace BakaPerms::database {
+
+/// A statement that took longer than the backend's slow-query threshold.
+struct SlowQueryReport {
+    std::string_view sql;
+    StatementPhases  phases;
+    std::string      plan;       // the backend's query plan, one indented step per line; empty if unavailable
+    std::uint64_t    suppressed; // slow statements left unreported since the previous report
+};
+
+/// Measures the phases of one statement call as consecutive laps of a single clock.
+class PhaseClock {
+public:
+    /// Time since construction or the previous lap.
+    auto lap() -> std::chrono::nanoseconds {
+        const auto now     = Clock::now();
+        const auto elapsed = now - last_;
+        last_              = now;
+        return elapsed;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point last_ = Clock::now();
+};
+
+/// Per-SQL-text aggregate of statement phases. Thread-safe; recording takes a short lock, which
+/// is small next to the cost of the statement itself.
+class StatementProfiler {
+public:
+    /// At most `capacity` distinct SQL texts are tracked; calls to others are not recorded.
+    explicit StatementProfiler(std::size_t capacity) : capacity_(capacity) {}
+
+    void record(std::string_view sql, const StatementPhases& phases);
+
+    /// Snapshot of every tracked statement, most total time first.
+    [[nodiscard]] auto profiles() const -> std::vector<StatementProfile>;
+
+private:
+    struct SqlHash {
+        using is_transparent = void;
+        auto operator()(const std::string_view sql) const noexcept -> std::size_t {
+            return std::hash<std::string_view>{}(sql);
+        }
+    };
+
+    std::size_t                                                                 capacity_;
+    mutable std::mutex                                                          mutex_;
+    std::unordered_map<std::string, StatementProfile, SqlHash, std::equal_to<>> profiles_;
+};
+
+/// Rate limit for slow-query reports: at most one per interval, the slow statements in between
+/// are only counted. Lock-free, so it can be consulted on every statement.
+class SlowQueryGate {
+public:
+    /// A zero `threshold` disables reports.
+    SlowQueryGate(std::chrono::milliseconds threshold, std::chrono::seconds interval)
+    : threshold_(threshold),
+      interval_(std::chrono::duration_cast<Clock::duration>(interval).count()) {}
+
+    /// If a statement that took `elapsed` should be reported now, the number of slow statements
+    /// suppressed since the previous report; std::nullopt otherwise.
+    auto admit(std::chrono::nanoseconds elapsed) -> std::optional<std::uint64_t>;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::chrono::milliseconds  threshold_;
+    Clock::rep                 interval_;
+    std::atomic<Clock::rep>    nextReport_{0};
+    std::atomic<std::uint64_t> suppressed_{0};
+};
+
+} // namespace BakaPerms::database
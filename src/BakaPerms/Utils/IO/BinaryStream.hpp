@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace BakaPerms::utils::io {
+
+/// Raw host-endian writer for the mod's own binary files. Strings are u32-length-prefixed.
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::ostream& out) : out_(out) {}
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void write(const T& value) {
+        out_.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void writeArray(const std::span<const T> values) {
+        out_.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+    }
+
+    void writeString(const std::string_view str) {
+        write(static_cast<std::uint32_t>(str.size()));
+        out_.write(str.data(), static_cast<std::streamsize>(str.size()));
+    }
+
+    [[nodiscard]] bool good() const { return out_.good(); }
+
+private:
+    std::ostream& out_;
+};
+
+/// Counterpart of BinaryWriter. Every read returns false on EOF or a malformed value.
+class BinaryReader {
+public:
+    explicit BinaryReader(std::istream& in) : in_(in) {}
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    bool read(T& value) {
+        return static_cast<bool>(in_.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    bool readString(std::string& str, const std::uint32_t maxSize) {
+        std::uint32_t size = 0;
+        if (!read(size) || size > maxSize) return false;
+        str.resize(size);
+        return static_cast<bool>(in_.read(str.data(), size));
+    }
+
+private:
+    std::istream& in_;
+};
+
+} // namespace BakaPerms::utils::io
@@ -0,0 +1,75 @@
+#include "BakaPerms/Utils/IO/MappedFile.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BakaPerms::utils::io {
+
+#ifdef _WIN32
+
+auto MappedFile::open(const std::filesystem::path& path) -> std::unique_ptr<MappedFile> {
+    std::unique_ptr<MappedFile> mapped(new MappedFile());
+
+    const auto file = CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_DELETE, // allow the writer to rename a new image over this one
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    mapped->file_ = file;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) return nullptr;
+
+    mapped->mapping_ = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapped->mapping_) return nullptr;
+
+    mapped->data_ = static_cast<const std::byte*>(MapViewOfFile(mapped->mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (!mapped->data_) return nullptr;
+    mapped->size_ = static_cast<std::size_t>(size.QuadPart);
+    return mapped;
+}
+
+MappedFile::~MappedFile() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    if (file_) CloseHandle(file_);
+}
+
+#else
+
+auto MappedFile::open(const std::filesystem::path& path) -> std::unique_ptr<MappedFile> {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat st{};
+    void*       view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd); // the mapping keeps its own reference
+    if (view == MAP_FAILED) return nullptr;
+
+    std::unique_ptr<MappedFile> mapped(new MappedFile());
+    mapped->data_ = static_cast<const std::byte*>(view);
+    mapped->size_ = static_cast<std::size_t>(st.st_size);
+    return mapped;
+}
+
+MappedFile::~MappedFile() {
+    if (data_) munmap(const_cast<std::byte*>(data_), size_);
+}
+
+#endif
+
+} // namespace BakaPerms::utils::io
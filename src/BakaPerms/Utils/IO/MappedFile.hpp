@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <span>
+
+namespace BakaPerms::utils::io {
+
+/// Read-only memory mapping of a whole file. The view stays valid for the lifetime of the object.
+class MappedFile {
+public:
+    /// Map `path`, or return nullptr if it does not exist, is empty or cannot be mapped.
+    static auto open(const std::filesystem::path& path) -> std::unique_ptr<MappedFile>;
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] auto bytes() const noexcept -> std::span<const std::byte> { return {data_, size_}; }
+
+private:
+    MappedFile() = default;
+
+    const std::byte* data_{nullptr};
+    std::size_t      size_{0};
+#ifdef _WIN32
+    void* file_{nullptr};
+    void* mapping_{nullptr};
+#endif
+};
+
+} // namespace BakaPerms::utils::io
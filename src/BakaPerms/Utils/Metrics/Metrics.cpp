@@ -0,0 +1,36 @@
+#include "BakaPerms/Utils/Metrics/Metrics.hpp"
+
+#include <cmath>
+
+namespace BakaPerms::utils::metrics {
+
+auto HistogramSnapshot::upperBound(const std::size_t i) -> std::chrono::nanoseconds {
+    const auto exponent = static_cast<int>(std::min(i, kBuckets - 2)) + kFirstBucket;
+    return std::chrono::nanoseconds(std::int64_t{1} << exponent);
+}
+
+auto HistogramSnapshot::quantile(const double q) const -> std::chrono::nanoseconds {
+    if (count == 0) return std::chrono::nanoseconds::zero();
+    // Nearest rank: the smallest bucket whose cumulative count reaches ceil(q * count).
+    const auto    target = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(count)));
+    const auto    rank   = std::max<std::uint64_t>(target, 1);
+    std::uint64_t seen   = 0;
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) return upperBound(i);
+    }
+    return upperBound(kBuckets - 1);
+}
+
+auto LatencyHistogram::snapshot() const -> HistogramSnapshot {
+    HistogramSnapshot result;
+    for (std::size_t i = 0; i < HistogramSnapshot::kBuckets; ++i) {
+        result.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    // The count is summed from the buckets so it always agrees with them.
+    for (const auto n : result.buckets) result.count += n;
+    result.sumNs = sumNs_.load(std::memory_order_relaxed);
+    return result;
+}
+
+} // namespace BakaPerms::utils::metrics
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace BakaPerms::utils::metrics {
+
+/// Monotonic event counter. Relaxed atomics: readers see a recent value, never a torn one.
+class Counter {
+public:
+    void add(const std::uint64_t n = 1) noexcept { value_.fetch_add(n, std::memory_order_relaxed); }
+
+    [[nodiscard]] auto value() const noexcept -> std::uint64_t { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> value_{0};
+};
+
+/// Point-in-time copy of a LatencyHistogram.
+struct HistogramSnapshot {
+    static constexpr std::size_t kBuckets     = 28;
+    static constexpr int         kFirstBucket = 8; // bucket i holds samples up to 2^(i + kFirstBucket) ns
+
+    std::array<std::uint64_t, kBuckets> buckets{}; // not cumulative; the last one is unbounded
+    std::uint64_t                       count{0};
+    std::uint64_t                       sumNs{0};
+
+    /// Upper bound of bucket `i`; the last bucket has none and reports its lower bound.
+    [[nodiscard]] static auto upperBound(std::size_t i) -> std::chrono::nanoseconds;
+
+    /// Upper bound of the bucket holding the q-quantile, so an estimate within a factor of two.
+    [[nodiscard]] auto quantile(double q) const -> std::chrono::nanoseconds;
+};
+
+/// Latency distribution in power-of-two buckets from 256 ns to ~17 s. Recording is a bit_width and
+/// two relaxed increments, cheap enough for every cache miss and SQL call.
+class LatencyHistogram {
+public:
+    void record(const std::chrono::nanoseconds elapsed) noexcept {
+        const auto ns     = static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(elapsed.count(), 0));
+        const auto width  = ns > 1 ? static_cast<int>(std::bit_width(ns - 1)) : 0;
+        const auto bucket = std::min<std::size_t>(
+            static_cast<std::size_t>(std::max(width - HistogramSnapshot::kFirstBucket, 0)),
+            HistogramSnapshot::kBuckets - 1
+        );
+        buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+        sumNs_.fetch_add(ns, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto snapshot() const -> HistogramSnapshot;
+
+private:
+    std::array<std::atomic<std::uint64_t>, HistogramSnapshot::kBuckets> buckets_{};
+    std::atomic<std::uint64_t>                                          sumNs_{0};
+};
+
+/// Records the time from construction to destruction into a histogram.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(LatencyHistogram& histogram) : histogram_(histogram), start_(Clock::now()) {}
+    ~ScopedTimer() { histogram_.record(Clock::now() - start_); }
+
+    ScopedTimer(const ScopedTimer&)            = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    LatencyHistogram& histogram_;
+    Clock::time_point start_;
+};
+
+/// Receives metric values from collectMetrics() implementations. Metrics of one family (same name)
+/// are reported consecutively; `labels` is empty or Prometheus label syntax such as op="query".
+class MetricVisitor {
+public:
+    virtual ~MetricVisitor() = default;
+
+    virtual void
+    counter(std::string_view name, std::string_view help, std::string_view labels, std::uint64_t value) = 0;
+    virtual void gauge(std::string_view name, std::string_view help, std::string_view labels, double value) = 0;
+    virtual void histogram(
+        std::string_view         name,
+        std::string_view         help,
+        std::string_view         labels,
+        const HistogramSnapshot& value
+    ) = 0;
+};
+
+} // namespace BakaPerms::utils::metrics
@@ -0,0 +1,67 @@
+#include "BakaPerms/Utils/Metrics/PrometheusText.hpp"
+
+#include <chrono>
+#include <format>
+#include <iterator>
+
+namespace BakaPerms::utils::metrics {
+
+namespace {
+
+auto toSeconds(const std::chrono::nanoseconds ns) -> double { return std::chrono::duration<double>(ns).count(); }
+
+// `{a="b"}`, `{a="b",le="0.5"}` or empty, from existing labels plus an optional extra one.
+auto labelSet(const std::string_view labels, const std::string_view extra = {}) -> std::string {
+    if (labels.empty() && extra.empty()) return {};
+    const auto separator = !labels.empty() && !extra.empty() ? "," : "";
+    return std::format("{{{}{}{}}}", labels, separator, extra);
+}
+
+} // namespace
+
+void PrometheusText::family(const std::string_view name, const std::string_view help, const std::string_view type) {
+    if (family_ == name) return;
+    family_ = name;
+    std::format_to(std::back_inserter(out_), "# HELP {} {}\n# TYPE {} {}\n", name, help, name, type);
+}
+
+void PrometheusText::counter(
+    const std::string_view name,
+    const std::string_view help,
+    const std::string_view labels,
+    const std::uint64_t    value
+) {
+    family(name, help, "counter");
+    std::format_to(std::back_inserter(out_), "{}{} {}\n", name, labelSet(labels), value);
+}
+
+void PrometheusText::gauge(
+    const std::string_view name,
+    const std::string_view help,
+    const std::string_view labels,
+    const double           value
+) {
+    family(name, help, "gauge");
+    std::format_to(std::back_inserter(out_), "{}{} {}\n", name, labelSet(labels), value);
+}
+
+void PrometheusText::histogram(
+    const std::string_view   name,
+    const std::string_view   help,
+    const std::string_view   labels,
+    const HistogramSnapshot& value
+) {
+    family(name, help, "histogram");
+    auto          out        = std::back_inserter(out_);
+    std::uint64_t cumulative = 0;
+    for (std::size_t i = 0; i + 1 < HistogramSnapshot::kBuckets; ++i) {
+        cumulative += value.buckets[i];
+        const auto le = std::format("le=\"{}\"", toSeconds(HistogramSnapshot::upperBound(i)));
+        std::format_to(out, "{}_bucket{} {}\n", name, labelSet(labels, le), cumulative);
+    }
+    std::format_to(out, "{}_bucket{} {}\n", name, labelSet(labels, "le=\"+Inf\""), value.count);
+    std::format_to(out, "{}_sum{} {}\n", name, labelSet(labels), toSeconds(std::chrono::nanoseconds(value.sumNs)));
+    std::format_to(out, "{}_count{} {}\n", name, labelSet(labels), value.count);
+}
+
+} // namespace BakaPerms::utils::metrics
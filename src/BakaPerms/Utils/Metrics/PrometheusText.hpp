@@ -0,0 +1,32 @@
+#pragma once
+
+#include "BakaPerms/Utils/Metrics/Metrics.hpp"
+
+#include <string>
+
+namespace BakaPerms::utils::metrics {
+
+/// Renders visited metrics in the Prometheus text exposition format (version 0.0.4), with
+/// latencies in seconds.
+class PrometheusText final : public MetricVisitor {
+public:
+    void counter(std::string_view name, std::string_view help, std::string_view labels, std::uint64_t value) override;
+    void gauge(std::string_view name, std::string_view help, std::string_view labels, double value) override;
+    void histogram(
+        std::string_view         name,
+        std::string_view         help,
+        std::string_view         labels,
+        const HistogramSnapshot& value
+    ) override;
+
+    [[nodiscard]] auto str() const -> const std::string& { return out_; }
+
+private:
+    // Writes the HELP and TYPE lines when `name` starts a new family.
+    void family(std::string_view name, std::string_view help, std::string_view type);
+
+    std::string out_;
+    std::string family_;
+};
+
+} // namespace BakaPerms::utils::metrics
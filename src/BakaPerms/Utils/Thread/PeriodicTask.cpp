@@ -0,0 +1,36 @@
+#include "BakaPerms/Utils/Thread/PeriodicTask.hpp"
+
+#include <algorithm>
+
+namespace BakaPerms::utils::thread {
+
+PeriodicTask::PeriodicTask(const std::chrono::milliseconds interval, std::function<void()> task)
+: interval_(interval),
+  task_(std::move(task)),
+  worker_([this] { loop(); }) {}
+
+PeriodicTask::~PeriodicTask() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+}
+
+void PeriodicTask::loop() {
+    auto next = std::chrono::steady_clock::now() + interval_;
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            if (cv_.wait_until(lock, next, [this] { return stopping_; })) return;
+        }
+        try {
+            task_();
+        } catch (...) {}
+        // Fixed rate, but a run that overran its slot does not trigger a burst of catch-up runs.
+        next = std::max(next + interval_, std::chrono::steady_clock::now());
+    }
+}
+
+} // namespace BakaPerms::utils::thread
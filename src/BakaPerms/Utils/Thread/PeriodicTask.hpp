@@ -0,0 +1,32 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace BakaPerms::utils::thread {
+
+/// Runs a task on its own thread every `interval`, the first time one interval after construction.
+/// The task must not throw; anything that escapes is swallowed so the thread keeps running.
+class PeriodicTask {
+public:
+    PeriodicTask(std::chrono::milliseconds interval, std::function<void()> task);
+    ~PeriodicTask(); // Wakes the thread and joins it; a run in progress finishes first.
+
+    PeriodicTask(const PeriodicTask&)            = delete;
+    PeriodicTask& operator=(const PeriodicTask&) = delete;
+
+private:
+    void loop();
+
+    std::chrono::milliseconds interval_;
+    std::function<void()>     task_;
+    std::mutex                mutex_;
+    std::condition_variable   cv_;
+    bool                      stopping_{false};
+    std::thread               worker_;
+};
+
+} // namespace BakaPerms::utils::thread
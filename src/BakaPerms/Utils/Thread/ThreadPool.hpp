@@ -0,0 +1,36 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BakaPerms::utils::thread {
+
+/// Fixed-size FIFO worker pool for background work that must stay off the server thread.
+/// Tasks must not throw; anything that escapes is swallowed so a worker never dies.
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t threads);
+    ~ThreadPool(); // Runs every task already queued, then joins.
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return workers_.size(); }
+
+private:
+    void workerLoop();
+
+    std::mutex                        mutex_;
+    std::condition_variable           cv_;
+    std::deque<std::function<void()>> tasks_;
+    bool                              stopping_{false};
+    std::vector<std::thread>          workers_;
+};
+
+} // namespace BakaPerms::utils::thread
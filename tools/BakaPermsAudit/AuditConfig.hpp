@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+namespace BakaPerms::audit {
+
+struct AuditConfigV1 {
+    int         version  = 1;
+    std::string Database = "permissions.db"; // a copy of the server's SQLite database; relative to dataDir
+    std::string Format   = "csv";            // "csv" or "jsonl"
+    std::string Output   = "audit.csv";      // relative path from dataDir, or absolute
+    int         Threads  = 0;                // workers, 0 for one per hardware thread
+};
+
+using AuditConfig = AuditConfigV1;
+
+} // namespace BakaPerms::audit
@@ -0,0 +1,94 @@
+#include "BakaPermsAudit/AuditMod.hpp"
+
+#include "BakaPerms/Core/PermissionAudit.hpp"
+#include "BakaPerms/Core/PermissionSnapshot.hpp"
+#include "BakaPerms/Data/PermissionRepository.hpp"
+#include "BakaPerms/Database/SQLite/SQLiteDatabase.h"
+#include "BakaPerms/StdAfx.hpp"
+#include "BakaPermsAudit/AuditConfig.hpp"
+
+#include <ll/api/Config.h>
+#include <ll/api/mod/RegisterHelper.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+
+namespace BakaPerms {
+
+// The permission code logs through BakaPerms::getInstance(); in this module that is the audit mod.
+BakaPerms& BakaPerms::getInstance() {
+    static BakaPerms instance;
+    return instance;
+}
+
+} // namespace BakaPerms
+
+namespace BakaPerms::audit {
+
+namespace {
+
+AuditConfig config;
+
+auto toFormat(const std::string& name) -> core::AuditFormat {
+    if (name == "csv") return core::AuditFormat::Csv;
+    if (name == "jsonl") return core::AuditFormat::JsonLines;
+    throw std::invalid_argument("Unknown audit format '" + name + "', expected \"csv\" or \"jsonl\"");
+}
+
+} // namespace
+
+AuditMod& AuditMod::getInstance() {
+    static AuditMod instance;
+    return instance;
+}
+
+bool AuditMod::load() {
+    const auto configPath = getSelf().getConfigDir() / "config.json";
+    if (ll::config::loadConfig(config, configPath)) {
+        ll::config::saveConfig(config, configPath);
+    }
+    return true;
+}
+
+bool AuditMod::enable() {
+    // Runs to completion before the server finishes starting; this mod is only loaded to audit.
+    try {
+        const auto dataDir = getSelf().getDataDir();
+        std::filesystem::create_directories(dataDir);
+
+        const auto dbPath = dataDir / config.Database;
+        if (!std::filesystem::exists(dbPath)) {
+            throw std::runtime_error("Database copy " + dbPath.string() + " not found");
+        }
+        const auto format  = toFormat(config.Format);
+        const auto threads = static_cast<std::size_t>(std::max(config.Threads, 0));
+
+        const auto started = std::chrono::steady_clock::now();
+
+        database::SQLiteDatabase    db(dbPath);
+        data::PermissionRepository  repo(db);
+        const core::PermissionAudit audit(core::PermissionSnapshot::load(repo));
+        logger.info("Auditing {} subjects on {} nodes", audit.subjectCount(), audit.nodeCount());
+
+        const auto output  = dataDir / config.Output;
+        const auto stats   = audit.writeTo(output, format, threads);
+        const auto elapsed = std::chrono::steady_clock::now() - started;
+        logger.info(
+            "Wrote {} rows to {} in {} ms",
+            stats.rows,
+            output.string(),
+            std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+        );
+    } catch (const std::exception& e) {
+        logger.error("Audit failed: {}", e.what());
+    }
+    return true;
+}
+
+bool AuditMod::disable() { return true; }
+
+} // namespace BakaPerms::audit
+
+LL_REGISTER_MOD(BakaPerms::audit::AuditMod, BakaPerms::audit::AuditMod::getInstance());
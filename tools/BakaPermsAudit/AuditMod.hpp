@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ll/api/mod/NativeMod.h>
+
+namespace BakaPerms::audit {
+
+/// Offline mod that writes the effective permission of every subject on every ACL-bearing node of a
+/// copied SQLite database when the server enables it. It links its own copy of the permission code and
+/// only reads the copy, so it can run on a development server without touching live data.
+class AuditMod {
+public:
+    static AuditMod& getInstance();
+
+    AuditMod() : mSelf(*ll::mod::NativeMod::current()) {}
+
+    [[nodiscard]] ll::mod::NativeMod& getSelf() const { return mSelf; }
+
+    bool load();
+    bool enable();
+    bool disable();
+
+private:
+    ll::mod::NativeMod& mSelf;
+};
+
+} // namespace BakaPerms::audit
@@ -4,6 +4,7 @@ add_repositories("levimc-repo https://github.com/LiteLDev/xmake-repo.git")
 
 add_requires("levilamina", {configs = {target_type = "server"}})
 add_requires("sqlitecpp")
+add_requires("libpq")
 
 add_requires("levibuildscript")
 
@@ -19,6 +20,7 @@ target("BakaPerms")
     add_defines("BAKAPERMS_EXPORTS")
     add_packages("levilamina")
     add_packages("sqlitecpp")
+    add_packages("libpq")
     set_exceptions("none") -- To avoid conflicts with /EHa.
     set_kind("shared")
     set_languages("c++23")
@@ -26,4 +28,48 @@ target("BakaPerms")
     add_headerfiles("src/(BakaPerms/**.h)", "src/(BakaPerms/**.hpp)")
     add_files("src/**.cpp")
     add_files("src/BakaPerms/BakaPerms.rc")
-    add_includedirs("src")
\ No newline at end of file
+    add_includedirs("src")
+
+-- Benchmarks: a separate mod that runs the suites in bench/ when a server loads it.
+-- Build with `xmake build BakaPermsBench`; it is not part of the default build.
+target("BakaPermsBench")
+    set_default(false)
+    add_rules("@levibuildscript/linkrule")
+    add_rules("@levibuildscript/modpacker")
+    add_cxflags( "/EHa", "/utf-8", "/W4", "/w44265", "/w44289", "/w44296", "/w45263", "/w44738", "/w45204")
+    add_defines("NOMINMAX", "UNICODE")
+    add_defines("BAKAPERMS_EXPORTS")
+    add_packages("levilamina")
+    add_packages("sqlitecpp")
+    add_packages("libpq")
+    set_exceptions("none") -- To avoid conflicts with /EHa.
+    set_kind("shared")
+    set_languages("c++23")
+    set_symbols("debug")
+    -- The code under test, minus the mod entry point, commands, packet hooks and the allocator
+    -- override that bench/BakaPermsBench/AllocCounter.cpp replaces.
+    add_files(
+        "src/**.cpp|BakaPerms/BakaPerms.cpp|BakaPerms/Commands/*.cpp|BakaPerms/Utils/I18n/*.cpp|BakaPerms/Utils/Memory/*.cpp"
+    )
+    add_files("bench/**.cpp")
+    add_includedirs("src", "bench")
+
+-- Offline permission audit against a copied database; build with `xmake build BakaPermsAudit`.
+target("BakaPermsAudit")
+    set_default(false)
+    add_rules("@levibuildscript/linkrule")
+    add_rules("@levibuildscript/modpacker")
+    add_cxflags( "/EHa", "/utf-8", "/W4", "/w44265", "/w44289", "/w44296", "/w45263", "/w44738", "/w45204")
+    add_defines("NOMINMAX", "UNICODE")
+    add_defines("BAKAPERMS_EXPORTS")
+    add_packages("levilamina")
+    add_packages("sqlitecpp")
+    add_packages("libpq")
+    set_exceptions("none") -- To avoid conflicts with /EHa.
+    set_kind("shared")
+    set_languages("c++23")
+    set_symbols("debug")
+    -- The permission code, minus the mod entry point, commands and packet hooks.
+    add_files("src/**.cpp|BakaPerms/BakaPerms.cpp|BakaPerms/Commands/*.cpp|BakaPerms/Utils/I18n/*.cpp")
+    add_files("tools/**.cpp")
+    add_includedirs("src", "tools")